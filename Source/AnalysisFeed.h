@@ -0,0 +1,253 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+/**
+    Levels, scope data and spectrum windows from the audio thread to the editor.
+
+    The audio thread boils each stretch of samplesPerFrame samples down to one
+    Frame: input and output peaks, the output's min and max, and the VCA and VCF
+    modulation. It also copies a window of the mono output every 1/spectrumRateHz
+    seconds for the spectrum. Both go through wait-free single-producer,
+    single-consumer FIFOs (AbstractFifo) whose storage is allocated up front. When
+    a FIFO is full, the data is dropped rather than waited for.
+
+    Nothing is fed unless the editor has switched the feed on. While it's off, the
+    audio thread's only cost is one relaxed atomic load per call, and the FFT and
+    drawing don't exist at all, since they belong to the editor.
+*/
+class AnalysisFeed
+{
+public:
+    // Rate frames arrive at, whatever the sample rate
+    static constexpr double frameRateHz = 1000.0;
+
+    // Spectrum windows: 2048 samples, about 15 a second
+    static constexpr int spectrumOrder = 11;
+    static constexpr int spectrumSize = 1 << spectrumOrder;
+    static constexpr double spectrumRateHz = 15.0;
+
+    struct Frame
+    {
+        float inputPeak = 0.0f;   // largest magnitude on any channel
+        float outputPeak = 0.0f;
+        float outputMin = std::numeric_limits<float>::max();   // of the mean of all output channels
+        float outputMax = std::numeric_limits<float>::lowest();
+        float vcaGainMin = std::numeric_limits<float>::max();  // lowest gain the VCA applied
+        float vcfCutoffOctaves = 0.0f;                          // cutoff at the end of the frame
+    };
+
+    AnalysisFeed()
+        : frames(static_cast<size_t>(frameCapacity)),
+          spectrumSamples(static_cast<size_t>(spectrumCapacity))
+    {
+    }
+
+    /** Call while the audio thread isn't running. */
+    void prepare(double newSampleRate)
+    {
+        finishSpectrumWindow();
+
+        samplesPerFrame = juce::jmax(1, juce::roundToInt(newSampleRate / frameRateHz));
+        spectrumInterval = juce::jmax(spectrumSize, juce::roundToInt(newSampleRate / spectrumRateHz));
+        sampleRate.store(newSampleRate, std::memory_order_relaxed);
+        frameRate.store(newSampleRate / samplesPerFrame, std::memory_order_relaxed);
+        wasActive = false;
+    }
+
+    //==============================================================================
+    /** Message thread: switches the feed on while something is showing it. */
+    void setActive(bool shouldBeActive) noexcept  { active.store(shouldBeActive, std::memory_order_relaxed); }
+
+    double getSampleRate() const noexcept  { return sampleRate.load(std::memory_order_relaxed); }
+
+    double getFrameRate() const noexcept   { return frameRate.load(std::memory_order_relaxed); }
+
+    /** Message thread: moves up to maxFrames of the oldest frames into dest and returns how many. */
+    int readFrames(Frame* dest, int maxFrames) noexcept
+    {
+        const auto scope = frameFifo.read(juce::jmin(maxFrames, frameFifo.getNumReady()));
+        int n = 0;
+        scope.forEach([&](int index) { dest[n++] = frames[static_cast<size_t>(index)]; });
+        return n;
+    }
+
+    /** Message thread: copies the newest complete window into dest, which needs room for
+        spectrumSize samples, and drops any older ones. Returns false if none is ready.
+    */
+    bool readSpectrumWindow(float* dest) noexcept
+    {
+        bool found = false;
+
+        while (spectrumFifo.getNumReady() >= spectrumSize)
+        {
+            const auto scope = spectrumFifo.read(spectrumSize);
+            std::copy_n(spectrumSamples.data() + scope.startIndex1, scope.blockSize1, dest);
+            std::copy_n(spectrumSamples.data() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+            found = true;
+        }
+
+        return found;
+    }
+
+    //==============================================================================
+    /** Audio thread: input and output of the same samples, with the VCA gain and VCF cutoff
+        that were applied to them.
+    */
+    void process(const juce::dsp::AudioBlock<float>& input, const juce::dsp::AudioBlock<float>& output,
+                 const float* vcaGain, const float* vcfCutoffOctaves) noexcept
+    {
+        if (!active.load(std::memory_order_relaxed))
+        {
+            // A half-written window would put every later one out of step with the reader
+            finishSpectrumWindow();
+            wasActive = false;
+            return;
+        }
+
+        if (!wasActive)
+        {
+            wasActive = true;
+            current = {};
+            frameSamples = 0;
+            spectrumCountdown = 0;
+        }
+
+        const auto numChannels = output.getNumChannels();
+        const auto numSamples = output.getNumSamples();
+        const auto channelScale = 1.0f / static_cast<float>(numChannels);
+
+        for (size_t start = 0; start < numSamples; start += chunkSize)
+        {
+            const auto n = juce::jmin(chunkSize, numSamples - start);
+            float mono[chunkSize] {}, inputPeak[chunkSize] {}, outputPeak[chunkSize] {};
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* in = input.getChannelPointer(ch) + start;
+                const auto* out = output.getChannelPointer(ch) + start;
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    inputPeak[i] = juce::jmax(inputPeak[i], std::abs(in[i]));
+                    outputPeak[i] = juce::jmax(outputPeak[i], std::abs(out[i]));
+                    mono[i] += out[i];
+                }
+            }
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                mono[i] *= channelScale;
+
+                current.inputPeak = juce::jmax(current.inputPeak, inputPeak[i]);
+                current.outputPeak = juce::jmax(current.outputPeak, outputPeak[i]);
+                current.outputMin = juce::jmin(current.outputMin, mono[i]);
+                current.outputMax = juce::jmax(current.outputMax, mono[i]);
+                current.vcaGainMin = juce::jmin(current.vcaGainMin, vcaGain[start + i]);
+
+                if (++frameSamples >= samplesPerFrame)
+                {
+                    current.vcfCutoffOctaves = vcfCutoffOctaves[start + i];
+                    pushFrame();
+                }
+            }
+
+            feedSpectrum(mono, n);
+        }
+    }
+
+private:
+    // Frames held for the reader: about a second's worth
+    static constexpr int frameCapacity = 1024;
+
+    // Two windows, so one can be written while the reader hasn't taken the last
+    static constexpr int spectrumCapacity = 2 * spectrumSize + 1;
+
+    static constexpr size_t chunkSize = 64;
+
+    void pushFrame() noexcept
+    {
+        const auto scope = frameFifo.write(1);
+        scope.forEach([this](int index) { frames[static_cast<size_t>(index)] = current; });
+
+        current = {};
+        frameSamples = 0;
+    }
+
+    // Copies whole windows every spectrumInterval samples, and skips a window if the reader has fallen behind
+    void feedSpectrum(const float* mono, size_t numSamples) noexcept
+    {
+        for (size_t i = 0; i < numSamples;)
+        {
+            if (spectrumRemaining == 0)
+            {
+                if (spectrumCountdown > 0)
+                {
+                    const auto skip = juce::jmin(static_cast<size_t>(spectrumCountdown), numSamples - i);
+                    spectrumCountdown -= static_cast<int>(skip);
+                    i += skip;
+                    continue;
+                }
+
+                spectrumCountdown = spectrumInterval;
+
+                if (spectrumFifo.getFreeSpace() < spectrumSize)
+                    continue;
+
+                spectrumRemaining = spectrumSize;
+                spectrumCountdown -= spectrumSize;
+            }
+
+            const auto n = juce::jmin(static_cast<size_t>(spectrumRemaining), numSamples - i);
+            writeSpectrum(mono + i, static_cast<int>(n));
+            spectrumRemaining -= static_cast<int>(n);
+            i += n;
+        }
+    }
+
+    void writeSpectrum(const float* data, int numSamples) noexcept
+    {
+        const auto scope = spectrumFifo.write(numSamples);
+        std::copy_n(data, scope.blockSize1, spectrumSamples.data() + scope.startIndex1);
+        std::copy_n(data + scope.blockSize1, scope.blockSize2, spectrumSamples.data() + scope.startIndex2);
+    }
+
+    // Pads a window that was cut short, so the reader's windows stay aligned
+    void finishSpectrumWindow() noexcept
+    {
+        const float silence[chunkSize] {};
+
+        while (spectrumRemaining > 0)
+        {
+            const auto n = juce::jmin(spectrumRemaining, static_cast<int>(chunkSize));
+            writeSpectrum(silence, n);
+            spectrumRemaining -= n;
+        }
+    }
+
+    std::atomic<bool> active { false };
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<double> frameRate { frameRateHz };
+
+    juce::AbstractFifo frameFifo { frameCapacity };
+    std::vector<Frame> frames;
+
+    juce::AbstractFifo spectrumFifo { spectrumCapacity };
+    std::vector<float> spectrumSamples;
+
+    // Audio thread only
+    int samplesPerFrame = 44;
+    int spectrumInterval = spectrumSize;
+    Frame current;
+    int frameSamples = 0;
+    int spectrumCountdown = 0;
+    int spectrumRemaining = 0;
+    bool wasActive = false;
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisFeed)
+};
@@ -0,0 +1,193 @@
+#include "AnalysisView.h"
+
+#include <iterator>
+#include <tuple>
+
+#include "DspStages.h"
+
+AnalysisView::AnalysisView()
+    : scope(static_cast<size_t>(scopeLength)),
+      incoming(static_cast<size_t>(scopeLength)),
+      fftData(static_cast<size_t>(2 * AnalysisFeed::spectrumSize)),
+      spectrumDb(static_cast<size_t>(AnalysisFeed::spectrumSize / 2), spectrumFloorDb)
+{
+    setOpaque(true);
+}
+
+void AnalysisView::update(AnalysisFeed& feed)
+{
+    sampleRate = feed.getSampleRate();
+
+    // Meters fall at a fixed rate per update and jump straight up to any new peak
+    float inputPeak = 0.0f, outputPeak = 0.0f, vcaGainMin = 1.0f;
+    bool anyFrames = false;
+
+    int n;
+    while ((n = feed.readFrames(incoming.data(), scopeLength)) > 0)
+    {
+        anyFrames = true;
+
+        for (int i = 0; i < n; ++i)
+        {
+            const auto& frame = incoming[static_cast<size_t>(i)];
+            inputPeak = juce::jmax(inputPeak, frame.inputPeak);
+            outputPeak = juce::jmax(outputPeak, frame.outputPeak);
+            vcaGainMin = juce::jmin(vcaGainMin, frame.vcaGainMin);
+
+            scope[scopeNext] = frame;
+            scopeNext = (scopeNext + 1) % scope.size();
+        }
+    }
+
+    inputDb = juce::jmax(inputDb - meterFallDb, juce::Decibels::gainToDecibels(inputPeak, floorDb));
+    outputDb = juce::jmax(outputDb - meterFallDb, juce::Decibels::gainToDecibels(outputPeak, floorDb));
+    gainReductionDb = anyFrames ? juce::jmax(0.0f, -juce::Decibels::gainToDecibels(vcaGainMin, floorDb))
+                                : juce::jmax(0.0f, gainReductionDb - meterFallDb);
+
+    if (feed.readSpectrumWindow(fftData.data()))
+    {
+        window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(AnalysisFeed::spectrumSize));
+        fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+        // Hann window's coherent gain is 1/2, so a full-scale sine reads 0 dB
+        const auto scale = 4.0f / static_cast<float>(AnalysisFeed::spectrumSize);
+
+        for (size_t bin = 0; bin < spectrumDb.size(); ++bin)
+            spectrumDb[bin] = juce::jmax(spectrumDb[bin] - spectrumFallDb,
+                                         juce::Decibels::gainToDecibels(fftData[bin] * scale, spectrumFloorDb));
+    }
+    else
+    {
+        for (auto& level : spectrumDb)
+            level = juce::jmax(spectrumFloorDb, level - spectrumFallDb);
+    }
+
+    repaint();
+}
+
+void AnalysisView::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    auto area = getLocalBounds().toFloat().reduced(4.0f);
+    paintMeters(g, area.removeFromLeft(72.0f));
+    area.removeFromLeft(8.0f);
+
+    const auto scopeArea = area.removeFromLeft(area.getWidth() / 2.0f).reduced(2.0f, 0.0f);
+    paintScope(g, scopeArea);
+    paintSpectrum(g, area.reduced(2.0f, 0.0f));
+}
+
+void AnalysisView::paintMeters(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    const auto labels = area.removeFromBottom(14.0f);
+    const auto barWidth = area.getWidth() / 3.0f;
+
+    const std::tuple<const char*, float, juce::Colour> meters[] = {
+        { "IN", juce::jmap(inputDb, floorDb, 0.0f, 0.0f, 1.0f), juce::Colours::limegreen },
+        { "OUT", juce::jmap(outputDb, floorDb, 0.0f, 0.0f, 1.0f), juce::Colours::limegreen },
+        { "GR", juce::jlimit(0.0f, 1.0f, gainReductionDb / -floorDb), juce::Colours::orange }
+    };
+
+    g.setFont(11.0f);
+
+    for (size_t i = 0; i < std::size(meters); ++i)
+    {
+        const auto& [label, fill, colour] = meters[i];
+        const auto bar = juce::Rectangle<float>(area.getX() + barWidth * static_cast<float>(i), area.getY(),
+                                                barWidth, area.getHeight()).reduced(3.0f, 0.0f);
+
+        g.setColour(juce::Colours::darkgrey.darker());
+        g.fillRect(bar);
+
+        // Levels rise from the bottom, gain reduction hangs from the top
+        const auto height = bar.getHeight() * juce::jlimit(0.0f, 1.0f, fill);
+        g.setColour(colour);
+        g.fillRect(i < 2 ? bar.withTop(bar.getBottom() - height) : bar.withHeight(height));
+
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText(label, juce::Rectangle<float>(bar.getX() - 3.0f, labels.getY(), barWidth, labels.getHeight()),
+                   juce::Justification::centred);
+    }
+}
+
+void AnalysisView::paintScope(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    g.setColour(juce::Colours::darkgrey.darker());
+    g.drawRect(area);
+    g.drawHorizontalLine(juce::roundToInt(area.getCentreY()), area.getX(), area.getRight());
+
+    const auto numFrames = scope.size();
+    const auto xStep = area.getWidth() / static_cast<float>(numFrames);
+    const auto toY = [&](float value, float lo, float hi) { return juce::jmap(juce::jlimit(lo, hi, value), lo, hi, area.getBottom(), area.getY()); };
+
+    juce::Path vcaGain, vcfCutoff;
+
+    for (size_t i = 0; i < numFrames; ++i)
+    {
+        const auto& frame = scope[(scopeNext + i) % numFrames];
+        const auto x = area.getX() + xStep * static_cast<float>(i);
+
+        // The output as a min/max envelope per frame; frames that never arrived stay blank
+        const bool received = frame.outputMin <= frame.outputMax;
+
+        if (received)
+        {
+            const auto top = toY(frame.outputMax, -1.0f, 1.0f);
+            g.setColour(juce::Colours::limegreen);
+            g.drawVerticalLine(juce::roundToInt(x), top, juce::jmax(top + 1.0f, toY(frame.outputMin, -1.0f, 1.0f)));
+        }
+
+        // The VCA gain spans 0 to 2, the cutoff the VCF's 20 Hz to 20 kHz
+        const auto gainY = toY(received ? frame.vcaGainMin : 1.0f, 0.0f, 2.0f);
+        const auto cutoffY = toY(received ? frame.vcfCutoffOctaves : VcfStage::minCutoffOctaves,
+                                 VcfStage::minCutoffOctaves, VcfStage::maxCutoffOctaves);
+
+        if (i == 0)
+        {
+            vcaGain.startNewSubPath(x, gainY);
+            vcfCutoff.startNewSubPath(x, cutoffY);
+        }
+        else
+        {
+            vcaGain.lineTo(x, gainY);
+            vcfCutoff.lineTo(x, cutoffY);
+        }
+    }
+
+    g.setColour(juce::Colours::orange.withAlpha(0.8f));
+    g.strokePath(vcaGain, juce::PathStrokeType(1.0f));
+    g.setColour(juce::Colours::deepskyblue.withAlpha(0.8f));
+    g.strokePath(vcfCutoff, juce::PathStrokeType(1.0f));
+}
+
+void AnalysisView::paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    g.setColour(juce::Colours::darkgrey.darker());
+    g.drawRect(area);
+
+    // Log frequency from 20 Hz to 20 kHz, one point per pixel column
+    constexpr float minHz = 20.0f, maxHz = 20000.0f;
+    const auto binHz = static_cast<float>(sampleRate) / static_cast<float>(AnalysisFeed::spectrumSize);
+    const auto numColumns = juce::jmax(2, juce::roundToInt(area.getWidth()));
+
+    juce::Path spectrum;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto proportion = static_cast<float>(column) / static_cast<float>(numColumns - 1);
+        const auto hz = minHz * std::pow(maxHz / minHz, proportion);
+        const auto bin = juce::jlimit<size_t>(0, spectrumDb.size() - 1, static_cast<size_t>(hz / binHz));
+
+        const auto x = area.getX() + proportion * area.getWidth();
+        const auto y = juce::jmap(spectrumDb[bin], spectrumFloorDb, 0.0f, area.getBottom(), area.getY());
+
+        if (column == 0)
+            spectrum.startNewSubPath(x, y);
+        else
+            spectrum.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colours::limegreen);
+    g.strokePath(spectrum, juce::PathStrokeType(1.0f));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include "AnalysisFeed.h"
+
+// Input, output and VCA gain reduction meters, a scope of the output with the VCA and VCF
+// modulation over it, and the output's spectrum. Everything here runs on the message thread,
+// and only when the editor calls update().
+class AnalysisView : public juce::Component
+{
+public:
+    AnalysisView();
+
+    // Takes everything the audio thread has sent since the last call, then repaints
+    void update(AnalysisFeed& feed);
+
+    void paint(juce::Graphics&) override;
+
+private:
+    // Frames the scope shows, half a second at the feed's frame rate
+    static constexpr int scopeLength = 500;
+
+    // Lowest level the meters and the spectrum show
+    static constexpr float floorDb = -60.0f;
+    static constexpr float spectrumFloorDb = -90.0f;
+
+    // Fall of the meters and the spectrum per update, in dB
+    static constexpr float meterFallDb = 1.5f;
+    static constexpr float spectrumFallDb = 3.0f;
+
+    void paintMeters(juce::Graphics& g, juce::Rectangle<float> area) const;
+    void paintScope(juce::Graphics& g, juce::Rectangle<float> area) const;
+    void paintSpectrum(juce::Graphics& g, juce::Rectangle<float> area) const;
+
+    // The latest frames, oldest first once rotated by scopeNext
+    std::vector<AnalysisFeed::Frame> scope;
+    size_t scopeNext = 0;
+    std::vector<AnalysisFeed::Frame> incoming;
+
+    // Meter levels in dB, and the gain reduction in dB below unity
+    float inputDb = floorDb, outputDb = floorDb, gainReductionDb = 0.0f;
+
+    juce::dsp::FFT fft { AnalysisFeed::spectrumOrder };
+    juce::dsp::WindowingFunction<float> window { static_cast<size_t>(AnalysisFeed::spectrumSize),
+                                                 juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData;
+    std::vector<float> spectrumDb;
+    double sampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisView)
+};
@@ -0,0 +1,862 @@
+#include "DspStages.h"
+
+namespace
+{
+    // True when a control sits at or below zero for the whole block
+    bool isOff(const float* control, size_t numSamples) noexcept
+    {
+        return std::all_of(control, control + numSamples, [](float value) { return value <= 0.0f; });
+    }
+}
+
+//==============================================================================
+void VcaStage::process(const juce::dsp::AudioBlock<float>& block, const float* gain) const noexcept
+{
+    const auto numSamples = block.getNumSamples();
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+
+        // Add protection against extreme values
+        for (size_t i = 0; i < numSamples; ++i)
+            data[i] = juce::jlimit(-1.0f, 1.0f, data[i] * gain[i]);
+    }
+}
+
+//==============================================================================
+void VcfStage::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels <= SimdStateVariableFilter::maxChannels);
+
+    // g = tan (pi * fc / fs), sampled evenly in octaves. Frequencies are held just
+    // below Nyquist so low host rates can't push tan() past its pole.
+    const auto maxFrequency = 0.49 * spec.sampleRate;
+
+    for (int i = 0; i <= tableSize; ++i)
+    {
+        const auto octaves = minCutoffOctaves + (maxCutoffOctaves - minCutoffOctaves) * static_cast<float>(i) / tableSize;
+        const auto frequency = juce::jmin(std::exp2(static_cast<double>(octaves)), maxFrequency);
+        gTable[static_cast<size_t>(i)] = static_cast<float>(std::tan(juce::MathConstants<double>::pi * frequency / spec.sampleRate));
+    }
+
+    reset();
+}
+
+void VcfStage::reset()
+{
+    filter.reset();
+    lastCutoffOctaves = lastResonance = -1.0f;
+}
+
+void VcfStage::setType(FilterType type)
+{
+    filter.setType(type);
+}
+
+float VcfStage::lookupG(float cutoffOctaves) const noexcept
+{
+    constexpr auto scale = tableSize / (maxCutoffOctaves - minCutoffOctaves);
+    const auto position = juce::jlimit(0.0f, static_cast<float>(tableSize), (cutoffOctaves - minCutoffOctaves) * scale);
+    const auto index = juce::jmin(static_cast<int>(position), tableSize - 1);
+    const auto fraction = position - static_cast<float>(index);
+
+    const auto* entry = gTable.data() + index;
+    return entry[0] + fraction * (entry[1] - entry[0]);
+}
+
+void VcfStage::process(const juce::dsp::AudioBlock<float>& block, const float* cutoffOctaves, const float* resonance) noexcept
+{
+    // The coefficient buffers hold one sub-block, so longer blocks go through in several
+    for (size_t start = 0; start < block.getNumSamples(); start += maxSubBlockSize)
+    {
+        const auto numSamples = juce::jmin(block.getNumSamples() - start, maxSubBlockSize);
+
+        // Same coefficients as juce::dsp::StateVariableTPTFilter, once per frame for all channels
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            updateCoefficients(cutoffOctaves[start + i], resonance[start + i]);
+
+            g[i] = lastG;
+            k[i] = lastK;
+            h[i] = lastH;
+        }
+
+        filter.process(block.getSubBlock(start, numSamples), { g, k, h });
+    }
+}
+
+void VcfStage::process(const juce::dsp::AudioBlock<float>& block, float cutoffOctaves, float resonance) noexcept
+{
+    const auto numSamples = juce::jmin(block.getNumSamples(), maxSubBlockSize);
+
+    updateCoefficients(cutoffOctaves, resonance);
+    std::fill_n(g, numSamples, lastG);
+    std::fill_n(k, numSamples, lastK);
+    std::fill_n(h, numSamples, lastH);
+
+    for (size_t start = 0; start < block.getNumSamples(); start += maxSubBlockSize)
+        filter.process(block.getSubBlock(start, juce::jmin(block.getNumSamples() - start, maxSubBlockSize)), { g, k, h });
+}
+
+void VcfStage::updateCoefficients(float cutoffOctaves, float resonance) noexcept
+{
+    if (cutoffOctaves == lastCutoffOctaves && resonance == lastResonance)
+        return;
+
+    if (resonance != lastResonance)
+    {
+        lastResonance = resonance;
+        lastR2 = 1.0f / lastResonance;
+    }
+
+    lastCutoffOctaves = cutoffOctaves;
+    lastG = lookupG(lastCutoffOctaves);
+    lastK = lastG + lastR2;
+    lastH = 1.0f / (1.0f + lastG * lastK);
+}
+
+//==============================================================================
+// The Trasher curves. Each one bundles its drive law, the curve itself (per sample and over
+// a buffer) and its antiderivative for ADAA, so a kernel templated on it has no mode left to test.
+struct TrasherStage::Fuzz
+{
+    static float drive(float amount) noexcept  { return 1.0f + 40.0f * amount; }
+
+    static float curve(float x) noexcept  { return FastMath::tanh(x); }
+
+    static void curve(float* samples, size_t numSamples) noexcept
+    {
+        FastMath::tanh(samples, samples, numSamples);
+    }
+
+    // log (cosh (x)), rearranged so it can't overflow at high drive
+    static double integral(double x) noexcept
+    {
+        const auto a = std::abs(x);
+        return a + std::log1p(std::exp(-2.0 * a)) - 0.69314718055994530942;
+    }
+};
+
+struct TrasherStage::Scream
+{
+    static float drive(float amount) noexcept  { return amount * 3.0f; }
+
+    // sign (x) * (1 - e^-|x|)
+    static float curve(float x) noexcept
+    {
+        return std::copysign(1.0f - FastMath::exp2(-std::abs(x) * FastMath::log2e), x);
+    }
+
+    static void curve(float* samples, size_t numSamples) noexcept
+    {
+        alignas(16) float decay[maxSubBlockSize];
+        jassert(numSamples <= maxSubBlockSize);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            decay[i] = -std::abs(samples[i]) * FastMath::log2e;
+
+        FastMath::exp2(decay, decay, numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            samples[i] = std::copysign(1.0f - decay[i], samples[i]);
+    }
+
+    // The curve is odd, so its antiderivative is an even function of |x|
+    static double integral(double x) noexcept
+    {
+        const auto a = std::abs(x);
+        return a + std::exp(-a) - 1.0;
+    }
+};
+
+//==============================================================================
+void TrasherStage::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    jassert(spec.numChannels <= maxChannels);
+    juce::ignoreUnused(spec);
+
+    reset();
+}
+
+void TrasherStage::reset()
+{
+    adaaHistoryValid = false;
+}
+
+void TrasherStage::process(const juce::dsp::AudioBlock<float>& block, const float* amount, const float* tone,
+                           TrasherMode mode, bool antialiased) noexcept
+{
+    // With no drive the output is the input, so there's nothing to do
+    if (isOff(amount, block.getNumSamples()))
+    {
+        adaaHistoryValid = false;
+        return;
+    }
+
+    // The only place the mode is looked at: everything below is specialised for one curve
+    switch (mode)
+    {
+        case TrasherMode::Fuzz:
+            antialiased ? processAdaa<Fuzz>(block, amount, tone) : processNaive<Fuzz>(block, amount, tone);
+            break;
+
+        case TrasherMode::Scream:
+            antialiased ? processAdaa<Scream>(block, amount, tone) : processNaive<Scream>(block, amount, tone);
+            break;
+    }
+}
+
+template <typename Shaper>
+void TrasherStage::processNaive(const juce::dsp::AudioBlock<float>& block, const float* amount, const float* tone) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+
+    // Drive, shape and blend in runs of a sub-block, so the curve runs over a whole buffer at once
+    alignas(16) float shaped[maxSubBlockSize];
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+
+        for (size_t start = 0; start < numSamples; start += maxSubBlockSize)
+        {
+            const auto n = juce::jmin(maxSubBlockSize, numSamples - start);
+            auto* x = data + start;
+            const auto* a = amount + start;
+            const auto* t = tone + start;
+
+            for (size_t i = 0; i < n; ++i)
+                shaped[i] = x[i] * Shaper::drive(a[i]);
+
+            Shaper::curve(shaped, n);
+
+            for (size_t i = 0; i < n; ++i)
+                x[i] = a[i] <= 0.0f ? x[i] : shaped[i] * (1.0f - t[i]) + x[i] * t[i];
+        }
+    }
+
+    // The history goes stale, so ADAA restarts cleanly when it's next switched on
+    adaaHistoryValid = false;
+}
+
+template <typename Shaper>
+void TrasherStage::processAdaa(const juce::dsp::AudioBlock<float>& block, const float* amount, const float* tone) noexcept
+{
+    const auto numChannels = juce::jmin(block.getNumChannels(), maxChannels);
+    const auto numSamples = block.getNumSamples();
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+        auto history = adaaHistory[channel];
+
+        // Starting with the previous sample equal to the first makes the first output a plain shaper
+        if (!adaaHistoryValid)
+        {
+            history.input = data[0];
+            history.driven = data[0] * Shaper::drive(amount[0]);
+            history.integral = Shaper::integral(history.driven);
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+            data[i] = processSampleAdaa<Shaper>(data[i], amount[i], tone[i], history);
+
+        adaaHistory[channel] = history;
+    }
+
+    adaaHistoryValid = true;
+}
+
+template <typename Shaper>
+float TrasherStage::processSampleAdaa(float sample, float amount, float tone, AdaaHistory& history) noexcept
+{
+    const auto driven = sample * Shaper::drive(amount);
+    const auto integral = Shaper::integral(driven);
+    const auto delta = static_cast<double>(driven) - history.driven;
+
+    // The average of the curve between this sample and the last. When the two are too close
+    // together to divide, the curve at their midpoint is the same limit. Both are computed
+    // and one selected, so the loop has no data-dependent branch.
+    const bool canDivide = std::abs(delta) > 1.0e-5;
+    const auto difference = static_cast<float>((integral - history.integral) / (canDivide ? delta : 1.0));
+    const auto midpoint = Shaper::curve(0.5f * (driven + history.driven));
+    const auto processed = canDivide ? difference : midpoint;
+
+    // ADAA delays the shaped signal by half a sample, so the dry side of the tone blend is delayed to match
+    const auto dry = 0.5f * (sample + history.input);
+    history = { sample, driven, integral };
+
+    return amount <= 0.0f ? sample : processed * (1.0f - tone) + dry * tone;
+}
+
+//==============================================================================
+void EchoStage::prepare(const juce::dsp::ProcessSpec& spec, double maxDelaySeconds)
+{
+    maxDelay = juce::jmax(minimumDelayInSamples, static_cast<float>(std::ceil(spec.sampleRate * maxDelaySeconds)));
+
+    // Room for the longest delay, plus the two taps past it that Lagrange and Thiran read
+    const auto size = static_cast<size_t>(juce::nextPowerOfTwo(static_cast<int>(maxDelay) + 3));
+    mask = size - 1;
+
+    jassert(spec.numChannels <= maxBusChannels);
+    numChannels = juce::jlimit(static_cast<size_t>(1), maxBusChannels, static_cast<size_t>(spec.numChannels));
+    numGroups = (numChannels + numLanes - 1) / numLanes;
+
+    ring.assign(size * numGroups, Vec::expand(0.0f));
+    reset();
+}
+
+void EchoStage::reset()
+{
+    // The ring keeps its old contents; nothing reads a frame written before this point
+    framesWritten = 0;
+
+    for (auto& state : allpassStates)
+        state = Vec::expand(0.0f);
+
+    idle = false;
+    samplesSinceAudible = longestDelay = 0;
+}
+
+void EchoStage::setInterpolation(EchoInterpolation newInterpolation) noexcept
+{
+    // The allpass state means nothing to the other interpolators, or after a spell away
+    if (newInterpolation != interpolation)
+        for (auto& state : allpassStates)
+            state = Vec::expand(0.0f);
+
+    interpolation = newInterpolation;
+}
+
+double EchoStage::getTailLengthSeconds(double delaySeconds, float feedback, float amount) noexcept
+{
+    if (amount <= 0.0f)
+        return 0.0;
+
+    // Each trip round the line scales the repeats by the feedback
+    const auto repeats = feedback > 0.0f ? std::ceil(std::log(1.0e-3) / std::log(static_cast<double>(feedback))) : 0.0;
+    return delaySeconds * (1.0 + repeats);
+}
+
+void EchoStage::process(const juce::dsp::AudioBlock<float>& block, const float* delayInSamples,
+                        const float* feedback, const float* amount) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+
+    // Nothing in the line can be heard while the amount is zero. Rather than keep the line
+    // running for a tail nobody hears, stop, and start again from silence so no stale
+    // repeats come back; the amount ramps up from zero, so that's click-free.
+    if (isOff(amount, numSamples))
+    {
+        idle = true;
+        return;
+    }
+
+    if (idle)
+        reset();
+
+    const auto channelsUsed = juce::jmin(block.getNumChannels(), numChannels);
+    const auto frameSize = numGroups * numLanes;
+    float writtenPeak = 0.0f;
+
+    // One frame per sample, one channel per lane, as the ring holds them
+    alignas(64) float frames[maxSubBlockSize * maxGroups * numLanes];
+
+    for (size_t start = 0; start < numSamples; start += maxSubBlockSize)
+    {
+        const auto n = juce::jmin(maxSubBlockSize, numSamples - start);
+        const auto* d = delayInSamples + start;
+        const auto* fb = feedback + start;
+        const auto* a = amount + start;
+
+        // Unused lanes just carry silence round the line
+        if (channelsUsed < frameSize)
+            std::fill(frames, frames + n * frameSize, 0.0f);
+
+        for (size_t channel = 0; channel < channelsUsed; ++channel)
+        {
+            const auto* src = block.getChannelPointer(channel) + start;
+
+            for (size_t i = 0; i < n; ++i)
+                frames[i * frameSize + channel] = src[i];
+        }
+
+        float peak = 0.0f;
+
+        switch (interpolation)
+        {
+            case EchoInterpolation::Linear:     peak = processFrames<EchoInterpolation::Linear>(frames, d, fb, a, n); break;
+            case EchoInterpolation::Lagrange3:  peak = processFrames<EchoInterpolation::Lagrange3>(frames, d, fb, a, n); break;
+            case EchoInterpolation::Thiran:     peak = processFrames<EchoInterpolation::Thiran>(frames, d, fb, a, n); break;
+        }
+
+        for (size_t channel = 0; channel < channelsUsed; ++channel)
+        {
+            auto* dst = block.getChannelPointer(channel) + start;
+
+            for (size_t i = 0; i < n; ++i)
+                dst[i] = frames[i * frameSize + channel];
+        }
+
+        writtenPeak = juce::jmax(writtenPeak, peak);
+        writePosition = (writePosition + n) & mask;
+        framesWritten = juce::jmin(framesWritten + n, mask + 1);
+    }
+
+    // Anything audible in the line comes out within the longest delay read since it went in
+    if (writtenPeak > silenceThreshold)
+    {
+        samplesSinceAudible = 0;
+        longestDelay = 0;
+    }
+    else
+    {
+        samplesSinceAudible += static_cast<int>(numSamples);
+    }
+
+    const auto blockLongestDelay = *std::max_element(delayInSamples, delayInSamples + numSamples);
+    longestDelay = juce::jmax(longestDelay, static_cast<int>(std::ceil(blockLongestDelay)) + 1);
+}
+
+template <EchoInterpolation type>
+float EchoStage::processFrames(float* frames, const float* delayInSamples, const float* feedback,
+                               const float* amount, size_t numSamples) noexcept
+{
+    const auto frameSize = numGroups * numLanes;
+    auto* line = reinterpret_cast<float*>(ring.data());
+    const auto* silence = reinterpret_cast<const float*>(silentFrame);
+    auto highest = Vec::expand(0.0f), lowest = Vec::expand(0.0f);
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        // Where the taps are and how they're weighted is the same for every channel
+        const auto delay = juce::jlimit(minimumDelayInSamples, maxDelay, delayInSamples[i]);
+        const auto now = writePosition + i + mask + 1;
+        const auto fresh = framesWritten + i;
+        const auto tap = [&](size_t age) { return age <= fresh ? line + ((now - age) & mask) * frameSize : silence; };
+
+        const float* x0 = nullptr;
+        const float* x1 = nullptr;
+        const float* xm1 = nullptr;
+        const float* x2 = nullptr;
+        float w0 = 0.0f, w1 = 0.0f, wm1 = 0.0f, w2 = 0.0f;
+
+        if constexpr (type == EchoInterpolation::Thiran)
+        {
+            // Keep the allpass's share of the delay in [0.5, 1.5), where it's close to flat
+            const auto whole = static_cast<size_t>(delay - 0.5f);
+            const auto alpha = delay - static_cast<float>(whole);
+            w0 = (1.0f - alpha) / (1.0f + alpha);
+
+            x0 = tap(whole);
+            x1 = tap(whole + 1);
+        }
+        else
+        {
+            const auto whole = static_cast<size_t>(delay);
+            const auto f = delay - static_cast<float>(whole);
+
+            x0 = tap(whole);
+            x1 = tap(whole + 1);
+
+            if constexpr (type == EchoInterpolation::Linear)
+            {
+                w0 = 1.0f - f;
+                w1 = f;
+            }
+            else
+            {
+                // Four taps around the delay, at whole - 1 to whole + 2
+                xm1 = tap(whole - 1);
+                x2 = tap(whole + 2);
+
+                const auto fm1 = f - 1.0f, fm2 = f - 2.0f, fp1 = f + 1.0f;
+                wm1 = -f * fm1 * fm2 * (1.0f / 6.0f);
+                w0 = fp1 * fm1 * fm2 * 0.5f;
+                w1 = -fp1 * f * fm2 * 0.5f;
+                w2 = fp1 * f * fm1 * (1.0f / 6.0f);
+            }
+        }
+
+        auto* frame = frames + i * frameSize;
+        auto* written = line + ((writePosition + i) & mask) * frameSize;
+        const auto fb = Vec::expand(feedback[i]);
+        const auto a = Vec::expand(amount[i]);
+
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+            const auto offset = g * numLanes;
+            Vec delayed;
+
+            if constexpr (type == EchoInterpolation::Thiran)
+            {
+                auto& state = allpassStates[g];
+                state = Vec::expand(w0) * (Vec::fromRawArray(x0 + offset) - state) + Vec::fromRawArray(x1 + offset);
+                delayed = state;
+            }
+            else if constexpr (type == EchoInterpolation::Linear)
+            {
+                delayed = Vec::fromRawArray(x0 + offset) * Vec::expand(w0) + Vec::fromRawArray(x1 + offset) * Vec::expand(w1);
+            }
+            else
+            {
+                delayed = Vec::fromRawArray(xm1 + offset) * Vec::expand(wm1) + Vec::fromRawArray(x0 + offset) * Vec::expand(w0)
+                        + Vec::fromRawArray(x1 + offset) * Vec::expand(w1) + Vec::fromRawArray(x2 + offset) * Vec::expand(w2);
+            }
+
+            // Feed the input plus the repeats back in, and mix the repeats on top of the input
+            const auto input = Vec::fromRawArray(frame + offset);
+            const auto feedBack = input + delayed * fb;
+            feedBack.copyToRawArray(written + offset);
+            (input + delayed * a).copyToRawArray(frame + offset);
+
+            highest = Vec::max(highest, feedBack);
+            lowest = Vec::min(lowest, feedBack);
+        }
+    }
+
+    alignas(64) float highs[numLanes], lows[numLanes];
+    highest.copyToRawArray(highs);
+    lowest.copyToRawArray(lows);
+
+    float peak = 0.0f;
+    for (size_t lane = 0; lane < numLanes; ++lane)
+        peak = juce::jmax(peak, highs[lane], -lows[lane]);
+
+    return peak;
+}
+
+//==============================================================================
+void ReverbStage::prepare(double sampleRate)
+{
+    // The engines only make the wet signal; the dry path is mixed in here at the full rate
+    parameters.dryLevel = 0.0f;
+
+    for (size_t r = 0; r < numRates; ++r)
+    {
+        auto& tank = tanks[r];
+        tank.setParameters(parameters);
+
+        // Setting the rate also snaps the engines' ramps to the parameters above
+        const auto tankRate = sampleRate / static_cast<double>(1 << r);
+        for (auto& pair : tank.classic)
+            pair.setSampleRate(tankRate);
+
+        tank.fdn.setSampleRate(tankRate);
+    }
+
+    dryGain.reset(sampleRate, gainRampSeconds);
+    dryGain.setCurrentAndTargetValue(dryGainWhenOff * (1.0f - currentAmount));
+
+    settleSamples = static_cast<int>(std::ceil(gainRampSeconds * sampleRate)) + 1;
+    crossfadeSamples = juce::jmax(1, juce::roundToInt(crossfadeSeconds * sampleRate));
+    tankSamples = static_cast<int>(std::ceil(2.0 * longestLoopSeconds * sampleRate));
+    reset();
+}
+
+void ReverbStage::reset()
+{
+    for (auto& tank : tanks)
+    {
+        for (auto& pair : tank.classic)
+            pair.reset();
+
+        tank.fdn.reset();
+
+        for (auto& engineResamplers : tank.resamplers)
+            for (auto& resampler : engineResamplers)
+                resampler.reset();
+    }
+
+    crossfadeRemaining = 0;
+    samplesSinceOff = 0;
+    samplesSinceAudible = 0;
+    idle = false;
+}
+
+double ReverbStage::getTailLengthSeconds(float roomSize, float amount) noexcept
+{
+    if (amount <= 0.0f)
+        return 0.0;
+
+    return FdnReverb::getDecaySeconds(roomSize);
+}
+
+void ReverbStage::setParameters(float roomSize, float damping, float width, float amount) noexcept
+{
+    parameters.roomSize = roomSize;
+    parameters.damping = damping;
+    parameters.width = width;
+    parameters.wetLevel = amount;
+    parameters.dryLevel = 0.0f;
+
+    // Only the tanks that are playing need them; setEngine() catches the others up
+    tanks[static_cast<size_t>(current.rate)].setParameters(parameters);
+
+    if (crossfadeRemaining > 0 && fading.rate != current.rate)
+        tanks[static_cast<size_t>(fading.rate)].setParameters(parameters);
+
+    // The engines ramp everything else internally, over the same time
+    dryGain.setTargetValue(dryGainWhenOff * (1.0f - amount));
+    currentAmount = amount;
+}
+
+void ReverbStage::setEngine(ReverbEngine newEngine, ReverbRate newRate) noexcept
+{
+    const Selection newSelection { newEngine, newRate };
+
+    if (newSelection == current || crossfadeRemaining > 0)
+        return;
+
+    tanks[static_cast<size_t>(newSelection.rate)].setParameters(parameters);
+
+    // An asleep stage has nothing to fade; the new tank just starts empty when it wakes
+    if (!idle)
+    {
+        resetTank(newSelection);
+        fading = current;
+        crossfadeRemaining = crossfadeSamples;
+    }
+
+    current = newSelection;
+}
+
+void ReverbStage::resetTank(Selection which) noexcept
+{
+    auto& tank = tanks[static_cast<size_t>(which.rate)];
+
+    if (which.engine == ReverbEngine::Fdn)
+    {
+        tank.fdn.reset();
+    }
+    else
+    {
+        for (auto& pair : tank.classic)
+            pair.reset();
+    }
+
+    for (auto& resampler : tank.resamplers[static_cast<size_t>(which.engine)])
+        resampler.reset();
+}
+
+void ReverbStage::processWet(Selection which, float* const* channels, size_t numChannels, size_t numSamples) noexcept
+{
+    auto& tank = tanks[static_cast<size_t>(which.rate)];
+    auto* resamplers = tank.resamplers[static_cast<size_t>(which.engine)];
+    const auto numHalvings = static_cast<size_t>(which.rate);
+
+    // Down through each halving, the tank at the bottom, then back up into the same buffers
+    float halfRate[maxChannels][maxSubBlockSize / 2];
+    float quarterRate[maxChannels][maxSubBlockSize / 4];
+    float* levels[numRates][maxChannels] = {};
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        levels[0][ch] = channels[ch];
+        levels[1][ch] = halfRate[ch];
+        levels[2][ch] = quarterRate[ch];
+    }
+
+    size_t lengths[numRates] = { numSamples };
+
+    for (size_t h = 0; h < numHalvings; ++h)
+        lengths[h + 1] = resamplers[h].decimate(levels[h], levels[h + 1], numChannels, lengths[h]);
+
+    const auto numTankSamples = static_cast<int>(lengths[numHalvings]);
+
+    // The LFE neither feeds the tank nor hears it
+    float* tankChannels[maxChannels] = {};
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        if (static_cast<int>(ch) == lfeChannel)
+            std::fill_n(levels[numHalvings][ch], numTankSamples, 0.0f);
+        else
+            tankChannels[ch] = levels[numHalvings][ch];
+    }
+
+    if (which.engine == ReverbEngine::Fdn)
+    {
+        tank.fdn.process(tankChannels, numChannels, numTankSamples);
+    }
+    else
+    {
+        // Channels in pairs, in bus order; one whose partner is missing gets a mono tank
+        for (size_t ch = 0; ch < numChannels; ch += 2)
+        {
+            auto& pair = tank.classic[ch / 2];
+            auto* first = tankChannels[ch];
+            auto* second = ch + 1 < numChannels ? tankChannels[ch + 1] : nullptr;
+
+            if (first != nullptr && second != nullptr)
+                pair.processStereo(first, second, numTankSamples);
+            else if (first != nullptr || second != nullptr)
+                pair.processMono(first != nullptr ? first : second, numTankSamples);
+        }
+    }
+
+    for (size_t h = numHalvings; h-- > 0;)
+        resamplers[h].interpolate(levels[h + 1], lengths[h + 1], levels[h], numChannels, lengths[h]);
+}
+
+void ReverbStage::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    jassert(block.getNumSamples() <= maxSubBlockSize);
+    const auto numSamples = block.getNumSamples();
+    const auto numChannels = juce::jmin(block.getNumChannels(), maxChannels);
+
+    if (numChannels == 0)
+        return;
+
+    if (currentAmount <= 0.0f)
+    {
+        // Keep running until the wet gain has ramped all the way to zero
+        if (samplesSinceOff >= settleSamples)
+        {
+            idle = true;
+            crossfadeRemaining = 0;
+            dryGain.setCurrentAndTargetValue(dryGainWhenOff);
+            block.multiplyBy(dryGainWhenOff);
+            return;
+        }
+
+        samplesSinceOff += static_cast<int>(numSamples);
+    }
+    else
+    {
+        samplesSinceOff = 0;
+
+        // The engines ramp their wet gain back up from zero, so an empty tank fades in
+        if (idle)
+        {
+            resetTank(current);
+            idle = false;
+        }
+    }
+
+    float* channels[maxChannels] = {};
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        channels[ch] = block.getChannelPointer(ch);
+        std::copy_n(channels[ch], numSamples, input[ch]);
+    }
+
+    processWet(current, channels, numChannels, numSamples);
+
+    if (crossfadeRemaining > 0)
+    {
+        // The old tank gets its own copy of the input, then fades out linearly under the new one
+        float* fadingChannels[maxChannels] = {};
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            fadingChannels[ch] = fadingWet[ch];
+            std::copy_n(input[ch], numSamples, fadingWet[ch]);
+        }
+
+        processWet(fading, fadingChannels, numChannels, numSamples);
+
+        const auto step = 1.0f / static_cast<float>(crossfadeSamples);
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto remaining = crossfadeRemaining;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto oldGain = static_cast<float>(juce::jmax(remaining--, 0)) * step;
+                channels[ch][i] += (fadingWet[ch][i] - channels[ch][i]) * oldGain;
+            }
+        }
+
+        crossfadeRemaining -= static_cast<int>(numSamples);
+    }
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const auto gain = dryGain.getNextValue();
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            channels[ch][i] += input[ch][i] * gain;
+    }
+
+    // With no reverb to make up for it, the LFE keeps the level it has with the amount at zero
+    if (lfeChannel >= 0 && static_cast<size_t>(lfeChannel) < numChannels)
+        for (size_t i = 0; i < numSamples; ++i)
+            channels[lfeChannel][i] = input[lfeChannel][i] * dryGainWhenOff;
+
+    samplesSinceAudible = isSilent(block) ? samplesSinceAudible + static_cast<int>(numSamples) : 0;
+}
+
+//==============================================================================
+void LatencyCompensationStage::prepare(int numChannels, int maxDelayInSamples)
+{
+    history.setSize(juce::jmax(1, numChannels), maxDelayInSamples + 1);
+    reset();
+}
+
+void LatencyCompensationStage::reset()
+{
+    history.clear();
+    writePosition = 0;
+}
+
+void LatencyCompensationStage::setDelay(int delayInSamples) noexcept
+{
+    const auto newDelay = juce::jlimit(0, history.getNumSamples() - 1, delayInSamples);
+
+    // Nothing is recorded while the delay is zero, so start again from silence
+    if (newDelay != delay)
+    {
+        delay = newDelay;
+        reset();
+    }
+}
+
+void LatencyCompensationStage::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (delay == 0)
+        return;
+
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    const auto size = history.getNumSamples();
+    const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(history.getNumChannels()));
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+        auto* line = history.getWritePointer(static_cast<int>(channel));
+        auto position = writePosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            line[position] = data[i];
+
+            auto readPosition = position - delay;
+            if (readPosition < 0)
+                readPosition += size;
+
+            data[i] = line[readPosition];
+
+            if (++position == size)
+                position = 0;
+        }
+    }
+
+    writePosition = (writePosition + numSamples) % size;
+}
+
+//==============================================================================
+void MixStage::process(const juce::dsp::AudioBlock<float>& wet, const juce::dsp::AudioBlock<float>& dry,
+                       const float* dryWet) noexcept
+{
+    const auto numSamples = wet.getNumSamples();
+
+    for (size_t channel = 0; channel < wet.getNumChannels(); ++channel)
+    {
+        auto* wetData = wet.getChannelPointer(channel);
+        const auto* dryData = dry.getChannelPointer(channel);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            wetData[i] = dryData[i] * (1.0f - dryWet[i]) + wetData[i] * dryWet[i];
+    }
+}
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "DspTypes.h"
+#include "FastMath.h"
+#include "FdnReverb.h"
+#include "HalfbandResampler.h"
+#include "SimdStateVariableFilter.h"
+
+// Largest number of samples a stage processes in one call. Small enough that a
+// sub-block and its control signals stay in L1 while every stage runs over it.
+constexpr size_t maxSubBlockSize = 64;
+
+// Widest bus every stage keeps state for: 7.1
+constexpr size_t maxBusChannels = 8;
+
+// Peak level below which a signal counts as silence (-120 dBFS)
+constexpr float silenceThreshold = 1.0e-6f;
+
+inline bool isSilent(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto range = block.findMinAndMax();
+    return juce::jmax(-range.getStart(), range.getEnd()) <= silenceThreshold;
+}
+
+/**
+    Per-sample control signals for one sub-block. They're all rendered before
+    any audio stage runs, so the stage kernels never touch parameters or LFOs.
+*/
+struct ModulationBlock
+{
+    static constexpr int numBuffers = 11;
+
+    size_t numSamples = 0;
+
+    // Set when the cutoff and resonance hold one value for the whole sub-block
+    bool vcfIsStatic = false;
+
+    float* vcaGain = nullptr;
+    float* vcfCutoffOctaves = nullptr; // log2 of the cutoff in Hz
+    float* vcfResonance = nullptr;
+    float* trasher1Amount = nullptr;
+    float* trasher1Tone = nullptr;
+    float* trasher2Amount = nullptr;
+    float* trasher2Tone = nullptr;
+    float* echoDelay = nullptr;
+    float* echoFeedback = nullptr;
+    float* echoAmount = nullptr;
+    float* dryWet = nullptr;
+};
+
+//==============================================================================
+// Gain from the VCA LFO, with the chain's input clamp
+class VcaStage
+{
+public:
+    void process(const juce::dsp::AudioBlock<float>& block, const float* gain) const noexcept;
+};
+
+//==============================================================================
+// State variable filter with a per-sample cutoff and resonance, all channels in SIMD lanes.
+// The cutoff arrives in octaves (log2 Hz) and goes straight to the g coefficient through
+// a table built for the current sample rate, so audio-rate sweeps never call tan().
+class VcfStage
+{
+public:
+    // Cutoff range covered by the table: 20 Hz to 20 kHz
+    static constexpr float minCutoffOctaves = 4.3219281f;
+    static constexpr float maxCutoffOctaves = 14.2877124f;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+    void setType(FilterType type);
+
+    // Blocks of any length; the coefficients are worked out a sub-block at a time
+    void process(const juce::dsp::AudioBlock<float>& block, const float* cutoffOctaves, const float* resonance) noexcept;
+
+    // The same with the cutoff and resonance held for the whole block
+    void process(const juce::dsp::AudioBlock<float>& block, float cutoffOctaves, float resonance) noexcept;
+
+private:
+    float lookupG(float cutoffOctaves) const noexcept;
+    void updateCoefficients(float cutoffOctaves, float resonance) noexcept;
+
+    static constexpr int tableSize = 2048;
+
+    SimdStateVariableFilter filter;
+    std::array<float, tableSize + 1> gTable {};
+
+    // Coefficients for the last cutoff/resonance pair, reused while neither moves
+    float lastCutoffOctaves = -1.0f, lastResonance = -1.0f;
+    float lastR2 = 0.0f, lastG = 0.0f, lastK = 0.0f, lastH = 0.0f;
+
+    // Per-sample coefficients for the current sub-block
+    float g[maxSubBlockSize], k[maxSubBlockSize], h[maxSubBlockSize];
+};
+
+//==============================================================================
+// One Trasher slot: a waveshaper blended with its input by the tone control.
+// With antialiasing on, the shaper uses first-order antiderivative anti-aliasing (ADAA).
+// Each slot owns its ADAA history; the kernels are compiled once per curve and the
+// mode is only looked at once per block. The tone control is a dry/shaped blend rather
+// than a filter, and both curves are odd with no bias, so there is no DC to block.
+// A block with the amount at zero throughout passes straight through.
+class TrasherStage
+{
+public:
+    static constexpr size_t maxChannels = maxBusChannels;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    void process(const juce::dsp::AudioBlock<float>& block, const float* amount, const float* tone,
+                 TrasherMode mode, bool antialiased) noexcept;
+
+private:
+    // What ADAA needs from the previous sample of each channel
+    struct AdaaHistory
+    {
+        float input = 0.0f;       // before the drive gain, for the tone blend
+        float driven = 0.0f;      // after the drive gain
+        double integral = 0.0;    // antiderivative of the curve at `driven`
+    };
+
+    // Curves the kernels are specialised for
+    struct Fuzz;
+    struct Scream;
+
+    template <typename Shaper>
+    void processNaive(const juce::dsp::AudioBlock<float>& block, const float* amount, const float* tone) noexcept;
+
+    template <typename Shaper>
+    void processAdaa(const juce::dsp::AudioBlock<float>& block, const float* amount, const float* tone) noexcept;
+
+    template <typename Shaper>
+    static float processSampleAdaa(float sample, float amount, float tone, AdaaHistory& history) noexcept;
+
+    std::array<AdaaHistory, maxChannels> adaaHistory;
+    bool adaaHistoryValid = false;
+};
+
+//==============================================================================
+// Feedback echo, mixed on top of its input. The repeats are scaled by the amount alone,
+// so while it sits at zero the stage sleeps, and wakes with an empty line.
+//
+// Emptying the line doesn't touch the ring, which is megabytes at high rates and wide buses:
+// reset() just marks every frame in it as stale, and taps on stale frames read silence until
+// the write position has come round and overwritten them.
+//
+// The line is a power-of-two ring of frames sized for the longest delay at the rate the stage
+// runs at. Each frame holds one sample of every channel, a channel per SIMD lane, so a tap is
+// a single register load for all channels and its position and weights are worked out once
+// per sample rather than once per channel. The fractional part of the delay is handled by
+// linear or third-order Lagrange interpolation, or by a first-order Thiran allpass, which
+// keeps the top end of the repeats but smears fast delay changes a little.
+class EchoStage
+{
+public:
+    // Shortest delay the echo runs at, a little over a sub-block
+    static constexpr float minimumDelayInSamples = static_cast<float>(maxSubBlockSize + 2);
+
+    void prepare(const juce::dsp::ProcessSpec& spec, double maxDelaySeconds);
+    void reset();
+
+    void setInterpolation(EchoInterpolation newInterpolation) noexcept;
+
+    float getMaximumDelayInSamples() const noexcept  { return maxDelay; }
+
+    void process(const juce::dsp::AudioBlock<float>& block, const float* delayInSamples,
+                 const float* feedback, const float* amount) noexcept;
+
+    // True once nothing left in the line can come back above silenceThreshold
+    bool isTailSilent() const noexcept  { return idle || samplesSinceAudible > longestDelay; }
+
+    // Time for the repeats to fall by 60 dB
+    static double getTailLengthSeconds(double delaySeconds, float feedback, float amount) noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+    static constexpr size_t maxGroups = (maxBusChannels + numLanes - 1) / numLanes;
+
+    // Runs numSamples interleaved frames through the line and returns the peak written back
+    template <EchoInterpolation type>
+    float processFrames(float* frames, const float* delayInSamples, const float* feedback,
+                        const float* amount, size_t numSamples) noexcept;
+
+    // Frames of numGroups registers; lanes past numChannels stay silent
+    std::vector<Vec> ring;
+    size_t numChannels = 0, numGroups = 0;
+    Vec allpassStates[maxGroups];
+    size_t mask = 0;
+    size_t writePosition = 0;
+
+    // Frames written since the last reset, up to the ring's size; older ones read as silentFrame
+    size_t framesWritten = 0;
+    Vec silentFrame[maxGroups] {};
+    float maxDelay = 0.0f;
+
+    EchoInterpolation interpolation = EchoInterpolation::Linear;
+    bool idle = false;
+
+    // Samples since anything audible went into the line, and the longest delay read in that time
+    int samplesSinceAudible = 0;
+    int longestDelay = 0;
+};
+
+//==============================================================================
+// juce::Reverb or FdnReverb with the amount as its wet/dry balance. The tank can run at
+// half or quarter rate between halfband resamplers, while the dry signal always stays at
+// the full rate. Each rate has its own pair of engines, so switching engine or rate
+// crossfades from the old tank to the new one, which starts empty. Once the amount has
+// been zero long enough for the engines' own gain ramps to finish, the tank no longer
+// reaches the output and the stage sleeps, applying the dry gain by itself. It wakes
+// with an empty tank.
+//
+// On a bus wider than stereo, the FDN feeds every channel from one tank through its own
+// output taps; juce::Reverb is stereo only, so there is one per channel pair. An LFE
+// channel bypasses the tank, at the gain every channel has with the amount at zero.
+class ReverbStage
+{
+public:
+    void prepare(double sampleRate);
+    void reset();
+    void setParameters(float roomSize, float damping, float width, float amount) noexcept;
+
+    // A change made while the previous one is still fading is held back until it
+    // finishes, so call this every block
+    void setEngine(ReverbEngine newEngine, ReverbRate newRate) noexcept;
+
+    // Index of the bus's LFE channel, or -1 if it has none
+    void setLfeChannel(int channel) noexcept  { lfeChannel = channel; }
+
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+    // True once the output has stayed below silenceThreshold for longer than the tank's longest loop
+    bool isTailSilent() const noexcept  { return idle || samplesSinceAudible > tankSamples; }
+
+    // RT60 for a room size; both engines decay at the same rate
+    static double getTailLengthSeconds(float roomSize, float amount) noexcept;
+
+private:
+    static constexpr size_t maxChannels = maxBusChannels;
+    static constexpr size_t maxPairs = (maxChannels + 1) / 2;
+    static constexpr size_t numRates = 3;
+    static constexpr size_t numEngines = 2;
+
+    // Dry gain at amount 0, and how long the engines' gain ramps take
+    static constexpr float dryGainWhenOff = 2.0f;
+    static constexpr double gainRampSeconds = 0.01;
+
+    static constexpr double crossfadeSeconds = 0.02;
+
+    // Longer than either engine's longest loop at any sample rate
+    static constexpr double longestLoopSeconds = 0.1;
+
+    // Both engines at one rate, and each one's resamplers down to it: none at full rate,
+    // one at half and two at quarter. Each engine has its own, so either can fade out
+    // under the other.
+    struct Tank
+    {
+        juce::Reverb classic[maxPairs];
+        FdnReverb fdn;
+        HalfbandResampler resamplers[numEngines][numRates - 1];
+
+        void setParameters(const juce::Reverb::Parameters& newParameters) noexcept
+        {
+            for (auto& pair : classic)
+                pair.setParameters(newParameters);
+
+            fdn.setParameters(newParameters);
+        }
+    };
+
+    struct Selection
+    {
+        ReverbEngine engine = ReverbEngine::Classic;
+        ReverbRate rate = ReverbRate::Full;
+
+        bool operator==(const Selection& other) const noexcept  { return engine == other.engine && rate == other.rate; }
+    };
+
+    void resetTank(Selection which) noexcept;
+    void processWet(Selection which, float* const* channels, size_t numChannels, size_t numSamples) noexcept;
+
+    std::array<Tank, numRates> tanks;
+    juce::Reverb::Parameters parameters;
+    juce::SmoothedValue<float> dryGain;
+
+    Selection current, fading;
+    int lfeChannel = -1;
+    int crossfadeSamples = 0;
+    int crossfadeRemaining = 0;
+
+    // The block's input, for the dry path and for the tank being faded out
+    float input[maxChannels][maxSubBlockSize] {};
+    float fadingWet[maxChannels][maxSubBlockSize] {};
+
+    float currentAmount = 0.0f;
+    int settleSamples = 0;
+    int samplesSinceOff = 0;
+    bool idle = false;
+
+    int samplesSinceAudible = 0;
+    int tankSamples = 0;
+};
+
+//==============================================================================
+// Whole-sample delay that keeps the dry copy in step with the oversampled Trasher section
+class LatencyCompensationStage
+{
+public:
+    void prepare(int numChannels, int maxDelayInSamples);
+    void reset();
+    void setDelay(int delayInSamples) noexcept;
+
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    juce::AudioBuffer<float> history;
+    int writePosition = 0;
+    int delay = 0;
+};
+
+static_assert(SimdStateVariableFilter::maxChannels >= maxBusChannels
+              && HalfbandResampler::maxChannels >= maxBusChannels
+              && FdnReverb::maxChannels >= maxBusChannels, "Every stage has to cover the widest bus");
+
+//==============================================================================
+// Crossfade between the dry copy and the processed signal
+struct MixStage
+{
+    static void process(const juce::dsp::AudioBlock<float>& wet, const juce::dsp::AudioBlock<float>& dry,
+                        const float* dryWet) noexcept;
+};
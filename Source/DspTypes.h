@@ -0,0 +1,51 @@
+#pragma once
+
+enum class FilterType
+{
+    LowPass,
+    BandPass,
+    HighPass
+};
+
+enum class LfoShape
+{
+    Sine,
+    Triangle,
+    Saw,
+    Square,
+    Random
+};
+
+enum class TrasherMode
+{
+    Fuzz,
+    Scream
+};
+
+enum class EchoInterpolation
+{
+    Linear,
+    Lagrange3,
+    Thiran
+};
+
+enum class ReverbEngine
+{
+    Classic,
+    Fdn
+};
+
+enum class ReverbRate
+{
+    Full,
+    Half,
+    Quarter
+};
+
+enum class OversamplingFactor
+{
+    None = 1,
+    X2 = 2,
+    X4 = 4,
+    X8 = 8
+};
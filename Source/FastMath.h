@@ -0,0 +1,234 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstring>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON && JUCE_64BIT
+ #include <arm_neon.h>
+ #define KINA_FASTMATH_NEON 1
+#endif
+
+/**
+    Fast tanh and exp2 for the Trasher hot path.
+
+    The block functions run four samples at a time with SSE2 or NEON where
+    available, and use the scalar versions for the remainder. Both give the
+    same results to within the bounds below, which kina_bench --check-math
+    verifies against libm.
+
+    tanh:  rational approximation (odd degree-13 numerator, even degree-6
+           denominator). Defined for every finite input; beyond +/-7.905 the
+           result is +/-1 to within float precision.
+           Max absolute error: tanhMaxAbsoluteError over the whole float range.
+
+    exp2:  split into integer and fractional parts, 2^f by a degree-6
+           polynomial for f in [-0.5, 0.5], 2^i built in the exponent bits.
+           Inputs are clamped to [-126, 126], so results stay normal.
+           Max relative error: exp2MaxRelativeError over [-126, 126].
+*/
+namespace FastMath
+{
+    constexpr float tanhMaxAbsoluteError = 5.0e-7f;
+    constexpr float exp2MaxRelativeError = 3.0e-7f;
+
+    // e^x = 2^(x * log2e)
+    constexpr float log2e = 1.44269504088896341f;
+
+    namespace detail
+    {
+        constexpr float tanhClamp = 7.90531110763549805f;
+
+        constexpr float tanhAlpha13 = -2.76076847742355e-16f;
+        constexpr float tanhAlpha11 = 2.00018790482477e-13f;
+        constexpr float tanhAlpha9 = -8.60467152213735e-11f;
+        constexpr float tanhAlpha7 = 5.12229709037114e-08f;
+        constexpr float tanhAlpha5 = 1.48572235717979e-05f;
+        constexpr float tanhAlpha3 = 6.37261928875436e-04f;
+        constexpr float tanhAlpha1 = 4.89352455891786e-03f;
+
+        constexpr float tanhBeta6 = 1.19825839466702e-06f;
+        constexpr float tanhBeta4 = 1.18534705686654e-04f;
+        constexpr float tanhBeta2 = 2.26843463243900e-03f;
+        constexpr float tanhBeta0 = 4.89352518554385e-03f;
+
+        // Taylor coefficients of 2^f, (ln 2)^n / n!
+        constexpr float exp2C6 = 1.5403530e-4f;
+        constexpr float exp2C5 = 1.3333558e-3f;
+        constexpr float exp2C4 = 9.6181291e-3f;
+        constexpr float exp2C3 = 5.5504109e-2f;
+        constexpr float exp2C2 = 2.4022651e-1f;
+        constexpr float exp2C1 = 6.9314718e-1f;
+
+        constexpr float exp2Limit = 126.0f;
+    }
+
+    inline float tanh(float x) noexcept
+    {
+        using namespace detail;
+
+        x = juce::jlimit(-tanhClamp, tanhClamp, x);
+        const auto x2 = x * x;
+
+        auto p = tanhAlpha13;
+        p = p * x2 + tanhAlpha11;
+        p = p * x2 + tanhAlpha9;
+        p = p * x2 + tanhAlpha7;
+        p = p * x2 + tanhAlpha5;
+        p = p * x2 + tanhAlpha3;
+        p = p * x2 + tanhAlpha1;
+
+        auto q = tanhBeta6;
+        q = q * x2 + tanhBeta4;
+        q = q * x2 + tanhBeta2;
+        q = q * x2 + tanhBeta0;
+
+        return x * p / q;
+    }
+
+    inline float exp2(float x) noexcept
+    {
+        using namespace detail;
+
+        x = juce::jlimit(-exp2Limit, exp2Limit, x);
+
+        // Round to nearest, so the polynomial only has to cover [-0.5, 0.5]
+        const auto shifted = x + 0.5f;
+        auto i = static_cast<int>(shifted);
+        if (static_cast<float>(i) > shifted)
+            --i;
+
+        const auto f = x - static_cast<float>(i);
+
+        auto p = exp2C6;
+        p = p * f + exp2C5;
+        p = p * f + exp2C4;
+        p = p * f + exp2C3;
+        p = p * f + exp2C2;
+        p = p * f + exp2C1;
+        p = p * f + 1.0f;
+
+        const auto bits = static_cast<juce::uint32>(i + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    /** tanh of numSamples values. output may be the same as input. */
+    inline void tanh(const float* input, float* output, size_t numSamples) noexcept
+    {
+        using namespace detail;
+        size_t i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto lo = _mm_set1_ps(-tanhClamp), hi = _mm_set1_ps(tanhClamp);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), lo), hi);
+            const auto x2 = _mm_mul_ps(x, x);
+
+            auto p = _mm_set1_ps(tanhAlpha13);
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(tanhAlpha11));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(tanhAlpha9));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(tanhAlpha7));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(tanhAlpha5));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(tanhAlpha3));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(tanhAlpha1));
+
+            auto q = _mm_set1_ps(tanhBeta6);
+            q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(tanhBeta4));
+            q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(tanhBeta2));
+            q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(tanhBeta0));
+
+            _mm_storeu_ps(output + i, _mm_div_ps(_mm_mul_ps(x, p), q));
+        }
+       #elif KINA_FASTMATH_NEON
+        const auto lo = vdupq_n_f32(-tanhClamp), hi = vdupq_n_f32(tanhClamp);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto x = vminq_f32(vmaxq_f32(vld1q_f32(input + i), lo), hi);
+            const auto x2 = vmulq_f32(x, x);
+
+            auto p = vdupq_n_f32(tanhAlpha13);
+            p = vmlaq_f32(vdupq_n_f32(tanhAlpha11), p, x2);
+            p = vmlaq_f32(vdupq_n_f32(tanhAlpha9), p, x2);
+            p = vmlaq_f32(vdupq_n_f32(tanhAlpha7), p, x2);
+            p = vmlaq_f32(vdupq_n_f32(tanhAlpha5), p, x2);
+            p = vmlaq_f32(vdupq_n_f32(tanhAlpha3), p, x2);
+            p = vmlaq_f32(vdupq_n_f32(tanhAlpha1), p, x2);
+
+            auto q = vdupq_n_f32(tanhBeta6);
+            q = vmlaq_f32(vdupq_n_f32(tanhBeta4), q, x2);
+            q = vmlaq_f32(vdupq_n_f32(tanhBeta2), q, x2);
+            q = vmlaq_f32(vdupq_n_f32(tanhBeta0), q, x2);
+
+            vst1q_f32(output + i, vdivq_f32(vmulq_f32(x, p), q));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            output[i] = tanh(input[i]);
+    }
+
+    /** 2^x of numSamples values. output may be the same as input. */
+    inline void exp2(const float* input, float* output, size_t numSamples) noexcept
+    {
+        using namespace detail;
+        size_t i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto lo = _mm_set1_ps(-exp2Limit), hi = _mm_set1_ps(exp2Limit);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), lo), hi);
+
+            // Truncate x + 0.5, then step down where that rounded towards zero from below
+            const auto shifted = _mm_add_ps(x, _mm_set1_ps(0.5f));
+            auto n = _mm_cvttps_epi32(shifted);
+            n = _mm_add_epi32(n, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(n), shifted)));
+            const auto f = _mm_sub_ps(x, _mm_cvtepi32_ps(n));
+
+            auto p = _mm_set1_ps(exp2C6);
+            p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C5));
+            p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C4));
+            p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C3));
+            p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C2));
+            p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(exp2C1));
+            p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+
+            const auto scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+            _mm_storeu_ps(output + i, _mm_mul_ps(p, scale));
+        }
+       #elif KINA_FASTMATH_NEON
+        const auto lo = vdupq_n_f32(-exp2Limit), hi = vdupq_n_f32(exp2Limit);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto x = vminq_f32(vmaxq_f32(vld1q_f32(input + i), lo), hi);
+
+            const auto shifted = vaddq_f32(x, vdupq_n_f32(0.5f));
+            auto n = vcvtq_s32_f32(shifted);
+            n = vaddq_s32(n, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(n), shifted)));
+            const auto f = vsubq_f32(x, vcvtq_f32_s32(n));
+
+            auto p = vdupq_n_f32(exp2C6);
+            p = vmlaq_f32(vdupq_n_f32(exp2C5), p, f);
+            p = vmlaq_f32(vdupq_n_f32(exp2C4), p, f);
+            p = vmlaq_f32(vdupq_n_f32(exp2C3), p, f);
+            p = vmlaq_f32(vdupq_n_f32(exp2C2), p, f);
+            p = vmlaq_f32(vdupq_n_f32(exp2C1), p, f);
+            p = vmlaq_f32(vdupq_n_f32(1.0f), p, f);
+
+            const auto scale = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23));
+            vst1q_f32(output + i, vmulq_f32(p, scale));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            output[i] = exp2(input[i]);
+    }
+}
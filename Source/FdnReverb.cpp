@@ -0,0 +1,257 @@
+#include "FdnReverb.h"
+
+namespace
+{
+    // Line and diffuser lengths at 44.1 kHz, scaled to the actual rate. The line lengths are
+    // mutually prime and spread over about an octave, so their modes don't pile up.
+    constexpr int lineTunings[] = { 1123, 1277, 1423, 1559, 1741, 1879, 2053, 2221 };
+    constexpr int diffuserTunings[] = { 556, 441, 341, 225 };
+
+    // Sylvester's Hadamard matrix: entry (row, line) is -1 when row & line has an odd number of bits.
+    // Left and right take rows 1 and 2, and any further channels the rows after them, wrapping
+    // round to the all-ones row last.
+    float hadamardSign(size_t slot, size_t line) noexcept
+    {
+        const auto row = (slot + 1) % 8;
+        auto bits = row & line;
+        bits ^= bits >> 2;
+        bits ^= bits >> 1;
+        return (bits & 1) != 0 ? -1.0f : 1.0f;
+    }
+
+    // juce::Reverb's gain staging. With the taps summed as they are, the impulse response
+    // comes out within 1 dB of juce::Reverb's across the room sizes.
+    constexpr float inputGain = 0.015f;
+    constexpr float wetScaleFactor = 3.0f;
+    constexpr float dryScaleFactor = 2.0f;
+
+    // juce::Reverb's comb feedback is roomSize * 0.28 + 0.7, and its longest comb plus
+    // stereo spread is 1640 samples at 44.1 kHz
+    constexpr float roomScale = 0.28f;
+    constexpr float roomOffset = 0.7f;
+    constexpr double longestCombSeconds = 1640.0 / 44100.0;
+
+    constexpr double rampSeconds = 0.01;
+}
+
+FdnReverb::FdnReverb()
+{
+    for (size_t slot = 0; slot < maxChannels; ++slot)
+    {
+        alignas(64) float signs[numLines];
+        for (size_t l = 0; l < numLines; ++l)
+            signs[l] = hadamardSign(slot, l);
+
+        for (size_t r = 0; r < numRegisters; ++r)
+            outputTaps[slot][r] = Vec::fromRawArray(signs + r * numLanes);
+    }
+
+    setSampleRate(sampleRate);
+}
+
+double FdnReverb::getDecaySeconds(float roomSize) noexcept
+{
+    const auto feedback = static_cast<double>(juce::jlimit(0.0f, 1.0f, roomSize) * roomScale + roomOffset);
+    return 3.0 * longestCombSeconds / -std::log10(feedback);
+}
+
+void FdnReverb::setSampleRate(double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+
+    const auto scale = sampleRate / 44100.0;
+
+    for (size_t i = 0; i < numDiffusers; ++i)
+        diffusers[i].buffer.assign(static_cast<size_t>(juce::roundToInt(diffuserTunings[i] * scale)), 0.0f);
+
+    for (size_t l = 0; l < numLines; ++l)
+        lengths[l] = static_cast<size_t>(juce::roundToInt(lineTunings[l] * scale));
+
+    const auto numFrames = static_cast<size_t>(juce::nextPowerOfTwo(static_cast<int>(lengths.back()) + 1));
+    mask = numFrames - 1;
+    ring.assign(numFrames * numRegisters, Vec::expand(0.0f));
+
+    for (auto* smoother : { &damping, &dryGain, &wetGain1, &wetGain2 })
+        smoother->reset(sampleRate, rampSeconds);
+
+    setParameters(parameters);
+    damping.setCurrentAndTargetValue(damping.getTargetValue());
+    dryGain.setCurrentAndTargetValue(dryGain.getTargetValue());
+    wetGain1.setCurrentAndTargetValue(wetGain1.getTargetValue());
+    wetGain2.setCurrentAndTargetValue(wetGain2.getTargetValue());
+    updateDecayGains(false);
+
+    reset();
+}
+
+void FdnReverb::reset()
+{
+    for (auto& diffuser : diffusers)
+    {
+        std::fill(diffuser.buffer.begin(), diffuser.buffer.end(), 0.0f);
+        diffuser.index = 0;
+    }
+
+    std::fill(ring.begin(), ring.end(), Vec::expand(0.0f));
+    writePosition = 0;
+
+    for (auto& state : lowpass)
+        state = Vec::expand(0.0f);
+}
+
+void FdnReverb::setParameters(const Parameters& newParameters)
+{
+    const bool roomChanged = newParameters.roomSize != parameters.roomSize;
+    parameters = newParameters;
+
+    const auto wet = parameters.wetLevel * wetScaleFactor;
+    dryGain.setTargetValue(parameters.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue(0.5f * wet * (1.0f + parameters.width));
+    wetGain2.setTargetValue(0.5f * wet * (1.0f - parameters.width));
+    damping.setTargetValue(parameters.damping * 0.4f);
+
+    if (roomChanged)
+        updateDecayGains(true);
+}
+
+void FdnReverb::updateDecayGains(bool ramp) noexcept
+{
+    // Each line loses 60 dB per decay time, in proportion to its length
+    const auto decaySamples = getDecaySeconds(parameters.roomSize) * sampleRate;
+    const auto rampLength = juce::jmax(1, juce::roundToInt(rampSeconds * sampleRate));
+
+    alignas(64) float targets[numLines];
+    for (size_t l = 0; l < numLines; ++l)
+        targets[l] = static_cast<float>(std::pow(10.0, -3.0 * static_cast<double>(lengths[l]) / decaySamples));
+
+    for (size_t r = 0; r < numRegisters; ++r)
+    {
+        const auto target = Vec::fromRawArray(targets + r * numLanes);
+
+        if (ramp)
+        {
+            decayGainSteps[r] = (target - decayGains[r]) * Vec::expand(1.0f / static_cast<float>(rampLength));
+        }
+        else
+        {
+            decayGains[r] = target;
+            decayGainSteps[r] = Vec::expand(0.0f);
+        }
+    }
+
+    decayRampRemaining = ramp ? rampLength : 0;
+}
+
+void FdnReverb::processStereo(float* left, float* right, int numSamples) noexcept
+{
+    float* channels[] = { left, right };
+    process(channels, 2, numSamples);
+}
+
+void FdnReverb::processMono(float* samples, int numSamples) noexcept
+{
+    process(&samples, 1, numSamples);
+}
+
+void FdnReverb::process(float* const* channels, size_t numChannels, int numSamples) noexcept
+{
+    jassert(numChannels <= maxChannels);
+    numChannels = juce::jmin(numChannels, maxChannels);
+
+    // The channels that take part, each on the next row of taps, and the slot of each one's
+    // partner for the width blend: the other half of its pair, if that's taking part too
+    constexpr auto noPartner = maxChannels;
+    float* active[maxChannels];
+    size_t slots[maxChannels], partners[maxChannels];
+    size_t numActive = 0;
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        slots[ch] = numActive;
+
+        if (channels[ch] != nullptr)
+            active[numActive++] = channels[ch];
+    }
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        const auto partner = ch ^ 1;
+
+        if (channels[ch] != nullptr)
+            partners[slots[ch]] = partner < numChannels && channels[partner] != nullptr ? slots[partner] : noPartner;
+    }
+
+    if (numActive == 0)
+        return;
+
+    // Past stereo, the summed input is scaled so uncorrelated channels fill the tank as a pair would
+    const auto inputScale = inputGain * (numActive > 2 ? std::sqrt(2.0f / static_cast<float>(numActive)) : 1.0f);
+    const auto* frames = reinterpret_cast<const float*>(ring.data());
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto input = 0.0f;
+        for (size_t slot = 0; slot < numActive; ++slot)
+            input += active[slot][i];
+
+        input *= inputScale;
+        for (auto& diffuser : diffusers)
+            input = diffuser.process(input);
+
+        // Each lane reads its own line at its own age
+        alignas(64) float tapped[numLines];
+        for (size_t l = 0; l < numLines; ++l)
+            tapped[l] = frames[((writePosition - lengths[l]) & mask) * numLines + l];
+
+        const auto dampingCoefficient = Vec::expand(damping.getNextValue());
+        Vec decayed[numRegisters];
+        float total = 0.0f;
+        float outputs[maxChannels] = {};
+
+        for (size_t r = 0; r < numRegisters; ++r)
+        {
+            const auto taps = Vec::fromRawArray(tapped + r * numLanes);
+
+            lowpass[r] = taps + (lowpass[r] - taps) * dampingCoefficient;
+            decayed[r] = lowpass[r] * decayGains[r];
+
+            total += decayed[r].sum();
+
+            for (size_t slot = 0; slot < numActive; ++slot)
+                outputs[slot] += (taps * outputTaps[slot][r]).sum();
+        }
+
+        if (decayRampRemaining > 0)
+        {
+            for (size_t r = 0; r < numRegisters; ++r)
+                decayGains[r] += decayGainSteps[r];
+
+            --decayRampRemaining;
+        }
+
+        // Householder reflection, I - 2/N, with the input added to every line
+        const auto fedBack = Vec::expand(input - total * (2.0f / static_cast<float>(numLines)));
+        auto* frame = ring.data() + writePosition * numRegisters;
+
+        for (size_t r = 0; r < numRegisters; ++r)
+            frame[r] = decayed[r] + fedBack;
+
+        writePosition = (writePosition + 1) & mask;
+
+        const auto dry = dryGain.getNextValue();
+        const auto wet1 = wetGain1.getNextValue();
+        const auto wet2 = wetGain2.getNextValue();
+
+        // Channels pair up as left and right do; one on its own gets no width blend
+        for (size_t slot = 0; slot < numActive; ++slot)
+        {
+            auto wet = outputs[slot] * wet1;
+
+            if (partners[slot] != noPartner)
+                wet += outputs[partners[slot]] * wet2;
+
+            active[slot][i] = wet + active[slot][i] * dry;
+        }
+    }
+}
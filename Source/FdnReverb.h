@@ -0,0 +1,98 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+    Feedback delay network reverb: eight delay lines fed back through a Householder
+    matrix, with a one-pole damping filter and a decay gain in each loop, after a short
+    chain of allpasses that diffuse the input.
+
+    The lines run side by side in SIMD lanes. All of them write to the same frame of one
+    interleaved ring buffer, so the write-back is a plain vector store; only the taps,
+    which sit at a different age in each lane, are read one at a time. The Householder
+    matrix costs one horizontal sum per sample.
+
+    Parameters, gain staging and the width control work as in juce::Reverb, down to the
+    dry gain of 2, so the two engines can be swapped without anything else noticing.
+    Room size sets the decay time juce::Reverb gives the same setting, and damping
+    covers the same range.
+
+    Wider buses share the one tank. Every channel feeds it and reads it back through its
+    own row of an 8x8 Hadamard matrix, so the outputs are mutually decorrelated for the
+    price of one extra horizontal sum each. Width blends each channel with its neighbour
+    in the pair it belongs to, as it does between left and right. The eighth channel gets
+    the all-ones row, which picks up more of the input and comes out a few dB hotter, so
+    buses with an LFE are best passed with the LFE left out.
+*/
+class FdnReverb
+{
+public:
+    using Parameters = juce::Reverb::Parameters;
+
+    static constexpr size_t maxChannels = 8;
+
+    FdnReverb();
+
+    void setSampleRate(double newSampleRate);
+    void reset();
+    void setParameters(const Parameters& newParameters);
+
+    void processStereo(float* left, float* right, int numSamples) noexcept;
+    void processMono(float* samples, int numSamples) noexcept;
+
+    /** Up to maxChannels channels, in place. A null channel is left out of the tank altogether. */
+    void process(float* const* channels, size_t numChannels, int numSamples) noexcept;
+
+    /** Time for juce::Reverb's longest comb to fall by 60 dB at this room size. */
+    static double getDecaySeconds(float roomSize) noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr size_t numLines = 8;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+    static constexpr size_t numRegisters = numLines / numLanes;
+    static_assert(numLines % numLanes == 0, "The lines have to fill whole registers");
+
+    static constexpr size_t numDiffusers = 4;
+
+    // Freeverb-style allpass on the mono input
+    struct Diffuser
+    {
+        std::vector<float> buffer;
+        size_t index = 0;
+
+        float process(float input) noexcept
+        {
+            const auto delayed = buffer[index];
+            buffer[index] = input + delayed * 0.5f;
+            index = index + 1 == buffer.size() ? 0 : index + 1;
+            return delayed - input;
+        }
+    };
+
+    static_assert(maxChannels <= numLines, "Each channel needs its own Hadamard row");
+
+    void updateDecayGains(bool ramp) noexcept;
+
+    Parameters parameters;
+    double sampleRate = 44100.0;
+
+    std::array<Diffuser, numDiffusers> diffusers;
+
+    // Frames of numLines samples, one lane per line
+    std::vector<Vec> ring;
+    size_t mask = 0;
+    size_t writePosition = 0;
+    std::array<size_t, numLines> lengths {};
+
+    Vec lowpass[numRegisters];
+    Vec decayGains[numRegisters], decayGainSteps[numRegisters];
+    int decayRampRemaining = 0;
+
+    // +/-1 per line for the output tap of each channel taking part, orthogonal so they decorrelate
+    Vec outputTaps[maxChannels][numRegisters];
+
+    juce::SmoothedValue<float> damping, dryGain, wetGain1, wetGain2;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+    Polyphase halfband resampler for running part of a stage at half the rate.
+
+    decimate() low-passes and keeps every other sample; interpolate() fills the gaps back
+    in. The filter is a 31-tap Kaiser-windowed halfband, flat to 0.187 of the full rate
+    and 80 dB down from 0.35. Every other tap is zero and the centre tap is 0.5, so each
+    direction costs eight multiplies per low-rate sample and channel.
+
+    Blocks can have any length, odd ones included. The interpolated output runs two
+    full-rate samples behind, which lets interpolate() always return exactly as many
+    samples as the matching decimate() call was given.
+*/
+class HalfbandResampler
+{
+public:
+    static constexpr size_t maxChannels = 8;
+
+    HalfbandResampler()  { reset(); }
+
+    void reset() noexcept
+    {
+        for (auto& channel : history)
+            std::fill(std::begin(channel), std::end(channel), 0.0f);
+
+        for (auto& channel : lowHistory)
+            std::fill(std::begin(channel), std::end(channel), 0.0f);
+
+        for (auto& channel : pending)
+            std::fill(std::begin(channel), std::end(channel), 0.0f);
+
+        historyIndex = lowHistoryIndex = 0;
+        phase = 0;
+        numPending = 2;
+    }
+
+    /** Filters numSamples full-rate samples and returns how many low-rate samples it wrote. */
+    size_t decimate(const float* const* input, float* const* output, size_t numChannels, size_t numSamples) noexcept
+    {
+        jassert(numChannels <= maxChannels);
+        size_t numOutput = 0;
+        auto index = historyIndex;
+        auto p = phase;
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            index = historyIndex;
+            p = phase;
+            numOutput = 0;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                // Each sample goes in twice, so the newest numTaps always sit side by side
+                history[ch][index] = history[ch][index + numTaps] = input[ch][i];
+                index = index + 1 == numTaps ? 0 : index + 1;
+
+                if (++p == 2)
+                {
+                    p = 0;
+                    const auto* window = history[ch] + index;
+                    auto sum = 0.5f * window[centre];
+
+                    for (size_t k = 0; k < numCoefficients; ++k)
+                        sum += coefficients[k] * (window[centre - 1 - 2 * k] + window[centre + 1 + 2 * k]);
+
+                    output[ch][numOutput++] = sum;
+                }
+            }
+        }
+
+        historyIndex = index;
+        phase = p;
+        return numOutput;
+    }
+
+    /** Writes numSamples full-rate samples from the numLowSamples the matching decimate() returned. */
+    void interpolate(const float* const* input, size_t numLowSamples, float* const* output,
+                     size_t numChannels, size_t numSamples) noexcept
+    {
+        jassert(numChannels <= maxChannels);
+        jassert(numPending + 2 * numLowSamples >= numSamples);
+
+        auto index = lowHistoryIndex;
+        size_t carried = 0;
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            index = lowHistoryIndex;
+            size_t written = 0;
+            float carry[2] = {};
+            carried = 0;
+
+            const auto emit = [&](float value)
+            {
+                if (written < numSamples)
+                    output[ch][written++] = value;
+                else
+                    carry[carried++] = value;
+            };
+
+            for (size_t i = 0; i < numPending; ++i)
+                emit(pending[ch][i]);
+
+            for (size_t i = 0; i < numLowSamples; ++i)
+            {
+                lowHistory[ch][index] = lowHistory[ch][index + numLowTaps] = input[ch][i];
+                index = index + 1 == numLowTaps ? 0 : index + 1;
+
+                // The zero-stuffed signal through the same filter, times two: the odd taps
+                // make one output and the centre tap passes the other straight through
+                const auto* window = lowHistory[ch] + index;
+                auto sum = 0.0f;
+
+                for (size_t k = 0; k < numCoefficients; ++k)
+                    sum += coefficients[k] * (window[numCoefficients - 1 - k] + window[numCoefficients + k]);
+
+                emit(2.0f * sum);
+                emit(window[numCoefficients]);
+            }
+
+            std::copy_n(carry, carried, pending[ch]);
+        }
+
+        lowHistoryIndex = index;
+        numPending = carried;
+    }
+
+private:
+    static constexpr size_t numCoefficients = 8;
+    static constexpr size_t numTaps = 4 * numCoefficients - 1;
+    static constexpr size_t centre = numTaps / 2;
+    static constexpr size_t numLowTaps = 2 * numCoefficients;
+
+    // The nonzero taps either side of the centre, nearest first, summing to 0.25
+    static constexpr float coefficients[numCoefficients] = {
+        3.130351437e-01f, -9.122178222e-02f, 4.153532689e-02f, -1.922700015e-02f,
+        8.020057977e-03f, -2.734350716e-03f, 6.422327220e-04f, -4.962823240e-05f
+    };
+
+    float history[maxChannels][2 * numTaps];
+    float lowHistory[maxChannels][2 * numLowTaps];
+    float pending[maxChannels][2];
+
+    size_t historyIndex = 0, lowHistoryIndex = 0;
+    int phase = 0;
+    size_t numPending = 2;
+};
@@ -0,0 +1,74 @@
+#include "Lfo.h"
+
+Lfo::Lfo()
+    : sineTable(getSineTable().data())
+{
+}
+
+void Lfo::prepare(double sampleRate)
+{
+    inverseSampleRate = 1.0 / sampleRate;
+    reset();
+}
+
+void Lfo::reset() noexcept
+{
+    phase = 0.0;
+    heldValue = 0.0f;
+}
+
+template <typename IncrementFn>
+void Lfo::renderShape(float* output, size_t numSamples, IncrementFn&& getIncrement) noexcept
+{
+    switch (shape)
+    {
+        case LfoShape::Sine:      render<LfoShape::Sine>(output, numSamples, getIncrement); break;
+        case LfoShape::Triangle:  render<LfoShape::Triangle>(output, numSamples, getIncrement); break;
+        case LfoShape::Saw:       render<LfoShape::Saw>(output, numSamples, getIncrement); break;
+        case LfoShape::Square:    render<LfoShape::Square>(output, numSamples, getIncrement); break;
+        case LfoShape::Random:    render<LfoShape::Random>(output, numSamples, getIncrement); break;
+    }
+}
+
+void Lfo::process(float frequencyHz, float* output, size_t numSamples) noexcept
+{
+    const auto increment = frequencyHz * inverseSampleRate;
+    renderShape(output, numSamples, [increment](size_t) { return increment; });
+}
+
+void Lfo::process(const float* frequencyHz, float* output, size_t numSamples) noexcept
+{
+    // Each increment is read before the sample is written, so output may alias frequencyHz
+    renderShape(output, numSamples, [this, frequencyHz](size_t i) { return frequencyHz[i] * inverseSampleRate; });
+}
+
+void Lfo::advance(float frequencyHz, size_t numSamples) noexcept
+{
+    phase += frequencyHz * inverseSampleRate * static_cast<double>(numSamples);
+
+    if (phase >= 1.0)
+    {
+        phase -= std::floor(phase);
+
+        // Only the last of the values skipped over would still be held
+        if (shape == LfoShape::Random)
+            heldValue = random.nextFloat() * 2.0f - 1.0f;
+    }
+}
+
+const Lfo::Table& Lfo::getSineTable()
+{
+    // One cycle indexed by phase in [0, 1], plus the value at the wrap so
+    // interpolation never has to look back to the start
+    static const auto table = []
+    {
+        Table t {};
+
+        for (int i = 0; i <= tableSize; ++i)
+            t[static_cast<size_t>(i)] = -std::sin(juce::MathConstants<float>::twoPi * static_cast<float>(i) / tableSize);
+
+        return t;
+    }();
+
+    return table;
+}
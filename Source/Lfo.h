@@ -0,0 +1,144 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+#include "DspTypes.h"
+
+/**
+    Low-frequency oscillator with its own phase accumulator.
+
+    Sine reads from a table that is computed once and shared by every instance.
+    Saw and Square are band-limited with PolyBLEP, and Triangle with PolyBLAMP, so the
+    VCA LFO can run at audio rate for ring modulation without aliasing at 1x.
+    Random is a sample-and-hold that picks a new value each time the phase wraps.
+
+    The output is in [-1, 1] and starts from the same point in the cycle as the
+    juce::dsp::Oscillator it replaces. Switching shape never rebuilds anything.
+*/
+class Lfo
+{
+public:
+    Lfo();
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Cheap enough to call every block
+    void setShape(LfoShape newShape) noexcept  { shape = newShape; }
+
+    /** Renders numSamples at a fixed rate. */
+    void process(float frequencyHz, float* output, size_t numSamples) noexcept;
+
+    /** Renders numSamples with a per-sample rate. frequencyHz may point at output. */
+    void process(const float* frequencyHz, float* output, size_t numSamples) noexcept;
+
+    /** Moves on by numSamples at a fixed rate without rendering, for when nothing listens. */
+    void advance(float frequencyHz, size_t numSamples) noexcept;
+
+private:
+    static constexpr int tableSize = 1024;
+    using Table = std::array<float, tableSize + 1>;
+
+    static const Table& getSineTable();
+
+    // Residual of a step of height 2 at t = 0, the jump of the saw and square, spread over one
+    // sample either side. It's +1 just before the discontinuity and -1 just after.
+    static float polyBlep(float t, float dt) noexcept
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0f;
+        }
+
+        if (t > 1.0f - dt)
+        {
+            t = (t - 1.0f) / dt;
+            return t * t + t + t + 1.0f;
+        }
+
+        return 0.0f;
+    }
+
+    // Residual of a unit change of slope at t = 0, in units of dt. That's half the integral of
+    // polyBlep, since polyBlep corrects a step of 2 rather than 1.
+    static float polyBlamp(float t, float dt) noexcept
+    {
+        if (t < dt)
+        {
+            const auto x = 1.0f - t / dt;
+            return x * x * x * (1.0f / 6.0f);
+        }
+
+        if (t > 1.0f - dt)
+        {
+            const auto x = 1.0f - (1.0f - t) / dt;
+            return x * x * x * (1.0f / 6.0f);
+        }
+
+        return 0.0f;
+    }
+
+    template <LfoShape shapeToUse, typename IncrementFn>
+    void render(float* output, size_t numSamples, IncrementFn&& getIncrement) noexcept
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto increment = getIncrement(i);
+            const auto t = static_cast<float>(phase);
+
+            // Corrections need at least two samples per cycle to make sense
+            const auto dt = juce::jmin(static_cast<float>(increment), 0.5f);
+
+            if constexpr (shapeToUse == LfoShape::Sine)
+            {
+                const auto position = phase * tableSize;
+                const auto index = static_cast<int>(position);
+                const auto fraction = static_cast<float>(position - index);
+                output[i] = sineTable[index] + fraction * (sineTable[index + 1] - sineTable[index]);
+            }
+            else if constexpr (shapeToUse == LfoShape::Triangle)
+            {
+                // Peak at t = 0, trough at t = 0.5, slope +/-4 per cycle
+                const auto half = t < 0.5f ? t + 0.5f : t - 0.5f;
+                output[i] = 2.0f * std::abs(2.0f * t - 1.0f) - 1.0f
+                          + 8.0f * dt * (polyBlamp(half, dt) - polyBlamp(t, dt));
+            }
+            else if constexpr (shapeToUse == LfoShape::Saw)
+            {
+                output[i] = 2.0f * t - 1.0f - polyBlep(t, dt);
+            }
+            else if constexpr (shapeToUse == LfoShape::Square)
+            {
+                // Steps down at t = 0 and up at t = 0.5
+                const auto half = t < 0.5f ? t + 0.5f : t - 0.5f;
+                output[i] = (t >= 0.5f ? 1.0f : -1.0f) - polyBlep(t, dt) + polyBlep(half, dt);
+            }
+            else
+            {
+                output[i] = heldValue;
+            }
+
+            phase += increment;
+            if (phase >= 1.0)
+            {
+                phase -= std::floor(phase);
+
+                if constexpr (shapeToUse == LfoShape::Random)
+                    heldValue = random.nextFloat() * 2.0f - 1.0f;
+            }
+        }
+    }
+
+    template <typename IncrementFn>
+    void renderShape(float* output, size_t numSamples, IncrementFn&& getIncrement) noexcept;
+
+    LfoShape shape = LfoShape::Sine;
+    const float* sineTable = nullptr;
+    double phase = 0.0;
+    double inverseSampleRate = 1.0 / 44100.0;
+
+    juce::Random random;
+    float heldValue = 0.0f;
+};
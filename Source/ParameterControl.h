@@ -0,0 +1,140 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+/**
+    Ties an editor control to a parameter, in place of the APVTS attachments.
+
+    Edits made with the control go straight to the parameter, wrapped in a
+    gesture. Changes coming the other way (host automation, presets,
+    Randomize) are not pushed to the control. The editor picks them up by
+    calling refresh() from its timer instead. Any number of changes between
+    two ticks then cost one comparison per parameter and at most one repaint
+    per control, with no listener callbacks or async messages per change.
+*/
+class ParameterControl
+{
+public:
+    virtual ~ParameterControl() = default;
+
+    /** Message thread: shows the parameter's value if it has moved since the last call. */
+    void refresh()
+    {
+        const auto value = parameter.getValue();
+
+        if (!juce::exactlyEqual(value, shownValue))
+        {
+            shownValue = value;
+            show(parameter.convertFrom0to1(value));
+        }
+    }
+
+protected:
+    explicit ParameterControl(juce::RangedAudioParameter& parameterToUse)
+        : parameter(parameterToUse) {}
+
+    // Puts a value in the parameter's own units on the control, without notifying anyone
+    virtual void show(float value) = 0;
+
+    void beginGesture()
+    {
+        if (gestureDepth++ == 0)
+            parameter.beginChangeGesture();
+    }
+
+    void endGesture()
+    {
+        if (gestureDepth > 0 && --gestureDepth == 0)
+            parameter.endChangeGesture();
+    }
+
+    // Sets the parameter from the control, as part of the current gesture if there is one
+    void setFromControl(float value)
+    {
+        const auto normalised = parameter.convertTo0to1(value);
+        shownValue = normalised;
+
+        if (juce::exactlyEqual(normalised, parameter.getValue()))
+            return;
+
+        beginGesture();
+        parameter.setValueNotifyingHost(normalised);
+        endGesture();
+    }
+
+    juce::RangedAudioParameter& parameter;
+
+private:
+    float shownValue = -1.0f;
+    int gestureDepth = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterControl)
+};
+
+//==============================================================================
+class SliderParameterControl : public ParameterControl
+{
+public:
+    SliderParameterControl(juce::RangedAudioParameter& parameterToUse, juce::Slider& sliderToUse)
+        : ParameterControl(parameterToUse), slider(sliderToUse)
+    {
+        // The slider moves through the parameter's own range, skew and snapping included
+        const auto range = parameter.getNormalisableRange();
+
+        slider.setNormalisableRange({ static_cast<double>(range.start), static_cast<double>(range.end),
+                                      [range](double, double, double v) { return static_cast<double>(range.convertFrom0to1(static_cast<float>(v))); },
+                                      [range](double, double, double v) { return static_cast<double>(range.convertTo0to1(static_cast<float>(v))); },
+                                      [range](double, double, double v) { return static_cast<double>(range.snapToLegalValue(static_cast<float>(v))); } });
+
+        slider.textFromValueFunction = [this](double v) { return parameter.getText(parameter.convertTo0to1(static_cast<float>(v)), 0); };
+        slider.valueFromTextFunction = [this](const juce::String& text) { return static_cast<double>(parameter.convertFrom0to1(parameter.getValueForText(text))); };
+        slider.setDoubleClickReturnValue(true, range.convertFrom0to1(parameter.getDefaultValue()));
+
+        slider.onDragStart = [this] { beginGesture(); };
+        slider.onDragEnd = [this] { endGesture(); };
+        slider.onValueChange = [this] { setFromControl(static_cast<float>(slider.getValue())); };
+
+        refresh();
+    }
+
+private:
+    void show(float value) override  { slider.setValue(value, juce::dontSendNotification); }
+
+    juce::Slider& slider;
+};
+
+//==============================================================================
+// The box's items have to be in the same order as the parameter's choices
+class ComboBoxParameterControl : public ParameterControl
+{
+public:
+    ComboBoxParameterControl(juce::RangedAudioParameter& parameterToUse, juce::ComboBox& boxToUse)
+        : ParameterControl(parameterToUse), box(boxToUse)
+    {
+        box.onChange = [this] { setFromControl(static_cast<float>(box.getSelectedItemIndex())); };
+        refresh();
+    }
+
+private:
+    void show(float value) override  { box.setSelectedItemIndex(juce::roundToInt(value), juce::dontSendNotification); }
+
+    juce::ComboBox& box;
+};
+
+//==============================================================================
+class ButtonParameterControl : public ParameterControl
+{
+public:
+    ButtonParameterControl(juce::RangedAudioParameter& parameterToUse, juce::Button& buttonToUse)
+        : ParameterControl(parameterToUse), button(buttonToUse)
+    {
+        button.onClick = [this] { setFromControl(button.getToggleState() ? 1.0f : 0.0f); };
+        refresh();
+    }
+
+private:
+    void show(float value) override  { button.setToggleState(value >= 0.5f, juce::dontSendNotification); }
+
+    juce::Button& button;
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+
+#include "DspTypes.h"
+
+// Every parameter value the DSP needs, read once at the start of a block
+struct ParameterSnapshot
+{
+    float vcaLfoRate = 1.0f;
+    float vcaLfoAmount = 0.5f;
+    bool vcaLfoSync = false;
+    LfoShape vcaLfoShape = LfoShape::Sine;
+    float vcaAmount = 0.5f;
+
+    FilterType vcfType = FilterType::LowPass;
+    float vcfCutoff = 1000.0f;
+    float vcfResonance = 0.707f;
+    float vcfLfoRate = 1.0f;
+    float vcfLfoAmount = 0.0f;
+    bool vcfLfoSync = false;
+
+    TrasherMode trasher1Mode = TrasherMode::Fuzz;
+    float trasher1Amount = 0.0f;
+    float trasher1Tone = 0.5f;
+    bool trasher1Adaa = false;
+
+    TrasherMode trasher2Mode = TrasherMode::Fuzz;
+    float trasher2Amount = 0.0f;
+    float trasher2Tone = 0.5f;
+    bool trasher2Adaa = false;
+
+    float echoTime = 0.5f;
+    float echoFeedback = 0.5f;
+    float echoAmount = 0.3f;
+    bool echoSync = false;
+    EchoInterpolation echoInterpolation = EchoInterpolation::Linear;
+
+    float reverbSize = 0.5f;
+    float reverbDamping = 0.5f;
+    float reverbWidth = 1.0f;
+    float reverbAmount = 0.3f;
+    ReverbEngine reverbEngine = ReverbEngine::Classic;
+    ReverbRate reverbRate = ReverbRate::Full;
+
+    float dryWet = 1.0f;
+    int oversamplingOrder = 0;
+    bool parallelOffline = false;
+};
+
+// Raw parameter atomics, looked up by ID once so the audio thread never hashes a string
+struct ParameterPointers
+{
+    std::atomic<float>* vcaLfoRate = nullptr;
+    std::atomic<float>* vcaLfoAmount = nullptr;
+    std::atomic<float>* vcaLfoSync = nullptr;
+    std::atomic<float>* vcaLfoShape = nullptr;
+    std::atomic<float>* vcaAmount = nullptr;
+
+    std::atomic<float>* vcfType = nullptr;
+    std::atomic<float>* vcfCutoff = nullptr;
+    std::atomic<float>* vcfResonance = nullptr;
+    std::atomic<float>* vcfLfoRate = nullptr;
+    std::atomic<float>* vcfLfoAmount = nullptr;
+    std::atomic<float>* vcfLfoSync = nullptr;
+
+    std::atomic<float>* trasher1Mode = nullptr;
+    std::atomic<float>* trasher1Amount = nullptr;
+    std::atomic<float>* trasher1Tone = nullptr;
+    std::atomic<float>* trasher1Adaa = nullptr;
+
+    std::atomic<float>* trasher2Mode = nullptr;
+    std::atomic<float>* trasher2Amount = nullptr;
+    std::atomic<float>* trasher2Tone = nullptr;
+    std::atomic<float>* trasher2Adaa = nullptr;
+
+    std::atomic<float>* echoTime = nullptr;
+    std::atomic<float>* echoFeedback = nullptr;
+    std::atomic<float>* echoAmount = nullptr;
+    std::atomic<float>* echoSync = nullptr;
+    std::atomic<float>* echoInterpolation = nullptr;
+
+    std::atomic<float>* reverbSize = nullptr;
+    std::atomic<float>* reverbDamping = nullptr;
+    std::atomic<float>* reverbWidth = nullptr;
+    std::atomic<float>* reverbAmount = nullptr;
+    std::atomic<float>* reverbEngine = nullptr;
+    std::atomic<float>* reverbRate = nullptr;
+
+    std::atomic<float>* dryWet = nullptr;
+    std::atomic<float>* oversampling = nullptr;
+    std::atomic<float>* parallelOffline = nullptr;
+
+    ParameterSnapshot load() const noexcept
+    {
+        const auto index = [](const std::atomic<float>* p) { return static_cast<int>(p->load(std::memory_order_relaxed)); };
+        const auto flag = [](const std::atomic<float>* p) { return p->load(std::memory_order_relaxed) >= 0.5f; };
+        const auto value = [](const std::atomic<float>* p) { return p->load(std::memory_order_relaxed); };
+
+        ParameterSnapshot s;
+        s.vcaLfoRate = value(vcaLfoRate);
+        s.vcaLfoAmount = value(vcaLfoAmount);
+        s.vcaLfoSync = flag(vcaLfoSync);
+        s.vcaLfoShape = static_cast<LfoShape>(index(vcaLfoShape));
+        s.vcaAmount = value(vcaAmount);
+
+        s.vcfType = static_cast<FilterType>(index(vcfType));
+        s.vcfCutoff = value(vcfCutoff);
+        s.vcfResonance = value(vcfResonance);
+        s.vcfLfoRate = value(vcfLfoRate);
+        s.vcfLfoAmount = value(vcfLfoAmount);
+        s.vcfLfoSync = flag(vcfLfoSync);
+
+        s.trasher1Mode = static_cast<TrasherMode>(index(trasher1Mode));
+        s.trasher1Amount = value(trasher1Amount);
+        s.trasher1Tone = value(trasher1Tone);
+        s.trasher1Adaa = flag(trasher1Adaa);
+
+        s.trasher2Mode = static_cast<TrasherMode>(index(trasher2Mode));
+        s.trasher2Amount = value(trasher2Amount);
+        s.trasher2Tone = value(trasher2Tone);
+        s.trasher2Adaa = flag(trasher2Adaa);
+
+        s.echoTime = value(echoTime);
+        s.echoFeedback = value(echoFeedback);
+        s.echoAmount = value(echoAmount);
+        s.echoSync = flag(echoSync);
+        s.echoInterpolation = static_cast<EchoInterpolation>(index(echoInterpolation));
+
+        s.reverbSize = value(reverbSize);
+        s.reverbDamping = value(reverbDamping);
+        s.reverbWidth = value(reverbWidth);
+        s.reverbAmount = value(reverbAmount);
+        s.reverbEngine = static_cast<ReverbEngine>(index(reverbEngine));
+        s.reverbRate = static_cast<ReverbRate>(index(reverbRate));
+
+        s.dryWet = value(dryWet);
+        s.oversamplingOrder = index(oversampling);
+        s.parallelOffline = flag(parallelOffline);
+        return s;
+    }
+};
+
+/**
+    Per-sample ramps for every continuous parameter. LFO rates use multiplicative
+    smoothing so a sweep moves evenly in octaves; the VCF cutoff is ramped linearly in
+    octaves (log2 Hz), which is the same curve, in the form the filter's coefficient
+    table takes. The reverb parameters are left out
+    because both reverb engines already ramp their own gains and coefficients.
+*/
+struct SmoothedParameters
+{
+    using Multiplicative = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+    using Linear = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>;
+
+    Multiplicative vcaLfoRate, vcfLfoRate;
+    Linear vcfCutoffOctaves;
+    Linear vcaLfoAmount, vcaAmount, vcfResonance, vcfLfoAmount;
+    Linear trasher1Amount, trasher1Tone, trasher2Amount, trasher2Tone;
+    Linear echoTime, echoFeedback, echoAmount;
+    Linear dryWet;
+
+    void reset(double sampleRate, const ParameterSnapshot& s, double rampLengthSeconds = 0.05)
+    {
+        forEach([sampleRate, rampLengthSeconds](auto& smoother) { smoother.reset(sampleRate, rampLengthSeconds); });
+        setTargets(s);
+        forEach([](auto& smoother) { smoother.setCurrentAndTargetValue(smoother.getTargetValue()); });
+    }
+
+    void setTargets(const ParameterSnapshot& s)
+    {
+        vcaLfoRate.setTargetValue(s.vcaLfoRate);
+        vcaLfoAmount.setTargetValue(s.vcaLfoAmount);
+        vcaAmount.setTargetValue(s.vcaAmount);
+
+        vcfCutoffOctaves.setTargetValue(std::log2(s.vcfCutoff));
+        vcfResonance.setTargetValue(s.vcfResonance);
+        vcfLfoRate.setTargetValue(s.vcfLfoRate);
+        vcfLfoAmount.setTargetValue(s.vcfLfoAmount);
+
+        trasher1Amount.setTargetValue(s.trasher1Amount);
+        trasher1Tone.setTargetValue(s.trasher1Tone);
+        trasher2Amount.setTargetValue(s.trasher2Amount);
+        trasher2Tone.setTargetValue(s.trasher2Tone);
+
+        echoTime.setTargetValue(s.echoTime);
+        echoFeedback.setTargetValue(s.echoFeedback);
+        echoAmount.setTargetValue(s.echoAmount);
+
+        dryWet.setTargetValue(s.dryWet);
+    }
+
+private:
+    template <typename Fn>
+    void forEach(Fn&& fn)
+    {
+        fn(vcaLfoRate); fn(vcfLfoRate); fn(vcfCutoffOctaves);
+        fn(vcaLfoAmount); fn(vcaAmount); fn(vcfResonance); fn(vcfLfoAmount);
+        fn(trasher1Amount); fn(trasher1Tone); fn(trasher2Amount); fn(trasher2Tone);
+        fn(echoTime); fn(echoFeedback); fn(echoAmount);
+        fn(dryWet);
+    }
+};
@@ -5,21 +5,17 @@ KinaVSTEditor::KinaVSTEditor(KinaVSTProcessor& p)
     : AudioProcessorEditor(&p), processor(p)
 {
     // Set up module panels
-    addAndMakeVisible(vcaGroup);
     vcaGroup.setText("VCA");
-    addAndMakeVisible(vcfGroup);
     vcfGroup.setText("VCF");
-    addAndMakeVisible(trasher1Group);
     trasher1Group.setText("Trasher 1");
-    addAndMakeVisible(trasher2Group);
     trasher2Group.setText("Trasher 2");
-    addAndMakeVisible(echoGroup);
     echoGroup.setText("Echo");
-    addAndMakeVisible(reverbGroup);
     reverbGroup.setText("Reverb");
-    addAndMakeVisible(globalGroup);
     globalGroup.setText("Global");
 
+    // The background image covers every pixel, so nothing behind the editor needs repainting
+    setOpaque(true);
+
     // Set up VCA controls
     setupRotarySlider(vcaLfoRateSlider, "Hz");
     setupRotarySlider(vcaLfoAmountSlider, "%");
@@ -50,124 +46,187 @@ KinaVSTEditor::KinaVSTEditor(KinaVSTProcessor& p)
     trasher1ModeBox.addItemList({"Fuzz", "Scream"}, 1);
     setupRotarySlider(trasher1AmountSlider, "%");
     setupRotarySlider(trasher1ToneSlider, "%");
+    trasher1AdaaButton.setButtonText("Antialiasing");
     addAndMakeVisible(trasher1ModeBox);
     addAndMakeVisible(trasher1AmountSlider);
     addAndMakeVisible(trasher1ToneSlider);
+    addAndMakeVisible(trasher1AdaaButton);
 
     // Set up Trasher 2 controls
     trasher2ModeBox.addItemList({"Fuzz", "Scream"}, 1);
     setupRotarySlider(trasher2AmountSlider, "%");
     setupRotarySlider(trasher2ToneSlider, "%");
+    trasher2AdaaButton.setButtonText("Antialiasing");
     addAndMakeVisible(trasher2ModeBox);
     addAndMakeVisible(trasher2AmountSlider);
     addAndMakeVisible(trasher2ToneSlider);
+    addAndMakeVisible(trasher2AdaaButton);
 
     // Set up Echo controls
     setupRotarySlider(echoTimeSlider, "s");
     setupRotarySlider(echoFeedbackSlider, "%");
     setupRotarySlider(echoAmountSlider, "%");
     echoSyncButton.setButtonText("Sync to BPM");
+    echoInterpolationBox.addItemList({"Linear", "Lagrange", "Thiran"}, 1);
     addAndMakeVisible(echoTimeSlider);
     addAndMakeVisible(echoFeedbackSlider);
     addAndMakeVisible(echoAmountSlider);
     addAndMakeVisible(echoSyncButton);
+    addAndMakeVisible(echoInterpolationBox);
 
     // Set up Reverb controls
     setupRotarySlider(reverbSizeSlider, "%");
     setupRotarySlider(reverbDampingSlider, "%");
     setupRotarySlider(reverbWidthSlider, "%");
     setupRotarySlider(reverbAmountSlider, "%");
+    reverbEngineBox.addItemList({"Classic", "FDN"}, 1);
+    reverbRateBox.addItemList({"Full rate", "Half rate", "Quarter rate"}, 1);
     addAndMakeVisible(reverbSizeSlider);
     addAndMakeVisible(reverbDampingSlider);
     addAndMakeVisible(reverbWidthSlider);
     addAndMakeVisible(reverbAmountSlider);
+    addAndMakeVisible(reverbEngineBox);
+    addAndMakeVisible(reverbRateBox);
 
     // Set up Global controls
     setupSlider(dryWetSlider, "%");
     oversamplingBox.addItemList({"Off", "2x", "4x", "8x"}, 1);
     randomizeButton.setButtonText("Randomize");
     randomizeButton.onClick = [this] { processor.randomizeParameters(); };
+    parallelOfflineButton.setButtonText("Parallel offline render");
     addAndMakeVisible(dryWetSlider);
     addAndMakeVisible(oversamplingBox);
     addAndMakeVisible(randomizeButton);
+    addAndMakeVisible(parallelOfflineButton);
+
+    addAndMakeVisible(analysisView);
+
+    // Tie every control to its parameter
+    attach(vcaLfoRateSlider, KinaVSTProcessor::VCA_LFO_RATE_ID);
+    attach(vcaLfoAmountSlider, KinaVSTProcessor::VCA_LFO_AMOUNT_ID);
+    attach(vcaAmountSlider, KinaVSTProcessor::VCA_AMOUNT_ID);
+    attach(vcaLfoShapeBox, KinaVSTProcessor::VCA_LFO_SHAPE_ID);
+    attach(vcaLfoSyncButton, KinaVSTProcessor::VCA_LFO_SYNC_ID);
+
+    attach(vcfCutoffSlider, KinaVSTProcessor::VCF_CUTOFF_ID);
+    attach(vcfResonanceSlider, KinaVSTProcessor::VCF_RESONANCE_ID);
+    attach(vcfLfoRateSlider, KinaVSTProcessor::VCF_LFO_RATE_ID);
+    attach(vcfLfoAmountSlider, KinaVSTProcessor::VCF_LFO_AMOUNT_ID);
+    attach(vcfTypeBox, KinaVSTProcessor::VCF_TYPE_ID);
+    attach(vcfLfoSyncButton, KinaVSTProcessor::VCF_LFO_SYNC_ID);
+
+    attach(trasher1ModeBox, KinaVSTProcessor::TRASHER1_MODE_ID);
+    attach(trasher1AmountSlider, KinaVSTProcessor::TRASHER1_AMOUNT_ID);
+    attach(trasher1ToneSlider, KinaVSTProcessor::TRASHER1_TONE_ID);
+    attach(trasher1AdaaButton, KinaVSTProcessor::TRASHER1_ADAA_ID);
+
+    attach(trasher2ModeBox, KinaVSTProcessor::TRASHER2_MODE_ID);
+    attach(trasher2AmountSlider, KinaVSTProcessor::TRASHER2_AMOUNT_ID);
+    attach(trasher2ToneSlider, KinaVSTProcessor::TRASHER2_TONE_ID);
+    attach(trasher2AdaaButton, KinaVSTProcessor::TRASHER2_ADAA_ID);
+
+    attach(echoTimeSlider, KinaVSTProcessor::ECHO_TIME_ID);
+    attach(echoFeedbackSlider, KinaVSTProcessor::ECHO_FEEDBACK_ID);
+    attach(echoAmountSlider, KinaVSTProcessor::ECHO_AMOUNT_ID);
+    attach(echoSyncButton, KinaVSTProcessor::ECHO_SYNC_ID);
+    attach(echoInterpolationBox, KinaVSTProcessor::ECHO_INTERPOLATION_ID);
+
+    attach(reverbSizeSlider, KinaVSTProcessor::REVERB_SIZE_ID);
+    attach(reverbDampingSlider, KinaVSTProcessor::REVERB_DAMPING_ID);
+    attach(reverbWidthSlider, KinaVSTProcessor::REVERB_WIDTH_ID);
+    attach(reverbAmountSlider, KinaVSTProcessor::REVERB_AMOUNT_ID);
+    attach(reverbEngineBox, KinaVSTProcessor::REVERB_ENGINE_ID);
+    attach(reverbRateBox, KinaVSTProcessor::REVERB_RATE_ID);
 
-    // Create parameter attachments
-    vcaLfoRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCA_LFO_RATE_ID, vcaLfoRateSlider);
-    vcaLfoAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCA_LFO_AMOUNT_ID, vcaLfoAmountSlider);
-    vcaAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCA_AMOUNT_ID, vcaAmountSlider);
-    vcaLfoShapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        processor.parameters, KinaVSTProcessor::VCA_LFO_SHAPE_ID, vcaLfoShapeBox);
-    vcaLfoSyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        processor.parameters, KinaVSTProcessor::VCA_LFO_SYNC_ID, vcaLfoSyncButton);
-
-    vcfCutoffAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCF_CUTOFF_ID, vcfCutoffSlider);
-    vcfResonanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCF_RESONANCE_ID, vcfResonanceSlider);
-    vcfLfoRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCF_LFO_RATE_ID, vcfLfoRateSlider);
-    vcfLfoAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::VCF_LFO_AMOUNT_ID, vcfLfoAmountSlider);
-    vcfTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        processor.parameters, KinaVSTProcessor::VCF_TYPE_ID, vcfTypeBox);
-    vcfLfoSyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        processor.parameters, KinaVSTProcessor::VCF_LFO_SYNC_ID, vcfLfoSyncButton);
-
-    trasher1ModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        processor.parameters, KinaVSTProcessor::TRASHER1_MODE_ID, trasher1ModeBox);
-    trasher1AmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::TRASHER1_AMOUNT_ID, trasher1AmountSlider);
-    trasher1ToneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::TRASHER1_TONE_ID, trasher1ToneSlider);
-
-    trasher2ModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        processor.parameters, KinaVSTProcessor::TRASHER2_MODE_ID, trasher2ModeBox);
-    trasher2AmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::TRASHER2_AMOUNT_ID, trasher2AmountSlider);
-    trasher2ToneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::TRASHER2_TONE_ID, trasher2ToneSlider);
-
-    echoTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::ECHO_TIME_ID, echoTimeSlider);
-    echoFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::ECHO_FEEDBACK_ID, echoFeedbackSlider);
-    echoAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::ECHO_AMOUNT_ID, echoAmountSlider);
-    echoSyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        processor.parameters, KinaVSTProcessor::ECHO_SYNC_ID, echoSyncButton);
-
-    reverbSizeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::REVERB_SIZE_ID, reverbSizeSlider);
-    reverbDampingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::REVERB_DAMPING_ID, reverbDampingSlider);
-    reverbWidthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::REVERB_WIDTH_ID, reverbWidthSlider);
-    reverbAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::REVERB_AMOUNT_ID, reverbAmountSlider);
-
-    dryWetAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        processor.parameters, KinaVSTProcessor::DRY_WET_ID, dryWetSlider);
-    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        processor.parameters, KinaVSTProcessor::OVERSAMPLING_ID, oversamplingBox);
-
-    setSize(800, 600);
+    attach(dryWetSlider, KinaVSTProcessor::DRY_WET_ID);
+    attach(oversamplingBox, KinaVSTProcessor::OVERSAMPLING_ID);
+    attach(parallelOfflineButton, KinaVSTProcessor::PARALLEL_OFFLINE_ID);
+
+    setSize(800, 760);
+
+    // Changes from the host, presets and Randomize reach the controls on this timer, so a burst
+    // of automation costs at most one repaint per control per tick
+    startTimerHz(refreshRateHz);
 }
 
 KinaVSTEditor::~KinaVSTEditor()
 {
+    stopTimer();
+    processor.getAnalysisFeed().setActive(false);
+}
+
+void KinaVSTEditor::attach(juce::Slider& slider, const juce::String& parameterId)
+{
+    if (auto* parameter = processor.parameters.getParameter(parameterId))
+        controls.push_back(std::make_unique<SliderParameterControl>(*parameter, slider));
+}
+
+void KinaVSTEditor::attach(juce::ComboBox& box, const juce::String& parameterId)
+{
+    if (auto* parameter = processor.parameters.getParameter(parameterId))
+        controls.push_back(std::make_unique<ComboBoxParameterControl>(*parameter, box));
+}
+
+void KinaVSTEditor::attach(juce::Button& button, const juce::String& parameterId)
+{
+    if (auto* parameter = processor.parameters.getParameter(parameterId))
+        controls.push_back(std::make_unique<ButtonParameterControl>(*parameter, button));
+}
+
+void KinaVSTEditor::timerCallback()
+{
+    for (auto& control : controls)
+        control->refresh();
+
+    // The audio thread only feeds the analysis while the editor is actually on screen
+    auto& feed = processor.getAnalysisFeed();
+    const bool showing = isShowing();
+    feed.setActive(showing);
+
+    if (showing)
+        analysisView.update(feed);
 }
 
 void KinaVSTEditor::paint(juce::Graphics& g)
 {
-    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+    // Redrawn only after a resize or a move to a display with a different scale;
+    // every other repaint just copies it
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (background.isNull() || !juce::approximatelyEqual(scale, backgroundScale))
+        renderBackground(scale);
+
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+void KinaVSTEditor::renderBackground(float scale)
+{
+    backgroundScale = scale;
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                             juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    auto& lookAndFeel = getLookAndFeel();
+    g.fillAll(lookAndFeel.findColour(juce::ResizableWindow::backgroundColourId));
+
+    // What GroupComponent::paint would draw, for every panel
+    for (auto* group : { &vcaGroup, &vcfGroup, &trasher1Group, &trasher2Group, &echoGroup, &reverbGroup, &globalGroup })
+    {
+        const auto bounds = group->getBounds();
+        juce::Graphics::ScopedSaveState state(g);
+        g.setOrigin(bounds.getPosition());
+        lookAndFeel.drawGroupComponentOutline(g, bounds.getWidth(), bounds.getHeight(), group->getText(),
+                                              group->getTextLabelPosition(), *group);
+    }
 }
 
 void KinaVSTEditor::resized()
 {
+    background = {};
+
     auto area = getLocalBounds().reduced(10);
+    analysisView.setBounds(area.removeFromBottom(150).reduced(5));
     auto topRow = area.removeFromTop(area.getHeight() / 2);
     auto bottomRow = area;
 
@@ -206,6 +265,7 @@ void KinaVSTEditor::resized()
     // Layout Trasher 1 controls
     auto trasher1Area = trasher1Group.getBounds().reduced(10);
     trasher1ModeBox.setBounds(trasher1Area.removeFromTop(20));
+    trasher1AdaaButton.setBounds(trasher1Area.removeFromTop(20));
     auto trasher1Bottom = trasher1Area.removeFromBottom(trasher1Area.getHeight() / 2);
     trasher1AmountSlider.setBounds(trasher1Area.reduced(5));
     trasher1ToneSlider.setBounds(trasher1Bottom.reduced(5));
@@ -213,6 +273,7 @@ void KinaVSTEditor::resized()
     // Layout Trasher 2 controls
     auto trasher2Area = trasher2Group.getBounds().reduced(10);
     trasher2ModeBox.setBounds(trasher2Area.removeFromTop(20));
+    trasher2AdaaButton.setBounds(trasher2Area.removeFromTop(20));
     auto trasher2Bottom = trasher2Area.removeFromBottom(trasher2Area.getHeight() / 2);
     trasher2AmountSlider.setBounds(trasher2Area.reduced(5));
     trasher2ToneSlider.setBounds(trasher2Bottom.reduced(5));
@@ -220,6 +281,7 @@ void KinaVSTEditor::resized()
     // Layout Echo controls
     auto echoArea = echoGroup.getBounds().reduced(10);
     echoSyncButton.setBounds(echoArea.removeFromTop(20));
+    echoInterpolationBox.setBounds(echoArea.removeFromTop(20));
     auto echoGrid = echoArea.removeFromTop(echoArea.getHeight() * 2 / 3);
     echoTimeSlider.setBounds(echoGrid.removeFromLeft(echoGrid.getWidth() / 2).reduced(5));
     echoFeedbackSlider.setBounds(echoGrid.reduced(5));
@@ -227,6 +289,9 @@ void KinaVSTEditor::resized()
 
     // Layout Reverb controls
     auto reverbArea = reverbGroup.getBounds().reduced(10);
+    auto reverbChoiceRow = reverbArea.removeFromTop(20);
+    reverbEngineBox.setBounds(reverbChoiceRow.removeFromLeft(reverbChoiceRow.getWidth() / 2));
+    reverbRateBox.setBounds(reverbChoiceRow);
     auto reverbTopRow = reverbArea.removeFromTop(reverbArea.getHeight() / 2);
     reverbSizeSlider.setBounds(reverbTopRow.removeFromLeft(reverbTopRow.getWidth() / 2).reduced(5));
     reverbDampingSlider.setBounds(reverbTopRow.reduced(5));
@@ -238,6 +303,7 @@ void KinaVSTEditor::resized()
     auto globalArea = globalGroup.getBounds().reduced(10);
     dryWetSlider.setBounds(globalArea.removeFromTop(globalArea.getHeight() / 3).reduced(5));
     oversamplingBox.setBounds(globalArea.removeFromTop(20));
+    parallelOfflineButton.setBounds(globalArea.removeFromTop(20));
     randomizeButton.setBounds(globalArea.reduced(5));
 }
 
@@ -2,9 +2,12 @@
 
 #include "../JUCE/modules/juce_audio_processors/juce_audio_processors.h"
 #include "../JUCE/modules/juce_gui_basics/juce_gui_basics.h"
+#include "AnalysisView.h"
+#include "ParameterControl.h"
 #include "PluginProcessor.h"
 
-class KinaVSTEditor : public juce::AudioProcessorEditor
+class KinaVSTEditor : public juce::AudioProcessorEditor,
+                      private juce::Timer
 {
 public:
     explicit KinaVSTEditor(KinaVSTProcessor&);
@@ -14,68 +17,65 @@ public:
     void resized() override;
 
 private:
+    // Fastest the controls follow parameter changes that didn't come from the editor
+    static constexpr int refreshRateHz = 30;
+
     KinaVSTProcessor& processor;
     
-    // Module panels
+    // Module panels. They only hold each panel's title and bounds: their frames are drawn
+    // into the background image rather than painted as components.
     juce::GroupComponent vcaGroup, vcfGroup, trasher1Group, trasher2Group, echoGroup, reverbGroup, globalGroup;
+
+    // The window background with every panel frame, at the scale it was last painted at.
+    // Cleared whenever the layout changes.
+    juce::Image background;
+    float backgroundScale = 0.0f;
     
     // VCA controls
     juce::Slider vcaLfoRateSlider, vcaLfoAmountSlider, vcaAmountSlider;
     juce::ComboBox vcaLfoShapeBox;
     juce::ToggleButton vcaLfoSyncButton;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcaLfoRateAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcaLfoAmountAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcaAmountAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> vcaLfoShapeAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> vcaLfoSyncAttachment;
     
     // VCF controls
     juce::Slider vcfCutoffSlider, vcfResonanceSlider, vcfLfoRateSlider, vcfLfoAmountSlider;
     juce::ComboBox vcfTypeBox;
     juce::ToggleButton vcfLfoSyncButton;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcfCutoffAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcfResonanceAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcfLfoRateAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> vcfLfoAmountAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> vcfTypeAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> vcfLfoSyncAttachment;
     
     // Trasher 1 controls
     juce::ComboBox trasher1ModeBox;
     juce::Slider trasher1AmountSlider, trasher1ToneSlider;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> trasher1ModeAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> trasher1AmountAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> trasher1ToneAttachment;
+    juce::ToggleButton trasher1AdaaButton;
     
     // Trasher 2 controls
     juce::ComboBox trasher2ModeBox;
     juce::Slider trasher2AmountSlider, trasher2ToneSlider;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> trasher2ModeAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> trasher2AmountAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> trasher2ToneAttachment;
+    juce::ToggleButton trasher2AdaaButton;
     
     // Echo controls
     juce::Slider echoTimeSlider, echoFeedbackSlider, echoAmountSlider;
     juce::ToggleButton echoSyncButton;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> echoTimeAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> echoFeedbackAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> echoAmountAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> echoSyncAttachment;
+    juce::ComboBox echoInterpolationBox;
     
     // Reverb controls
     juce::Slider reverbSizeSlider, reverbDampingSlider, reverbWidthSlider, reverbAmountSlider;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbSizeAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbDampingAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbWidthAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbAmountAttachment;
+    juce::ComboBox reverbEngineBox, reverbRateBox;
     
     // Global controls
     juce::Slider dryWetSlider;
     juce::ComboBox oversamplingBox;
     juce::TextButton randomizeButton;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> dryWetAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    juce::ToggleButton parallelOfflineButton;
+
+    // Meters, scope and spectrum along the bottom
+    AnalysisView analysisView;
+
+    std::vector<std::unique_ptr<ParameterControl>> controls;
     
+    void attach(juce::Slider& slider, const juce::String& parameterId);
+    void attach(juce::ComboBox& box, const juce::String& parameterId);
+    void attach(juce::Button& button, const juce::String& parameterId);
+    void renderBackground(float scale);
+    void timerCallback() override;
     void setupSlider(juce::Slider& slider, const juce::String& suffix = "");
     void setupRotarySlider(juce::Slider& slider, const juce::String& suffix = "");
     
@@ -1,4 +1,5 @@
 #include "PluginProcessor.h"
+#include "PluginEditor.h"
 
 // Parameter IDs
 const juce::String KinaVSTProcessor::VCA_LFO_RATE_ID = "vca_lfo_rate";
@@ -17,23 +18,29 @@ const juce::String KinaVSTProcessor::VCF_LFO_SYNC_ID = "vcf_lfo_sync";
 const juce::String KinaVSTProcessor::TRASHER1_MODE_ID = "trasher1_mode";
 const juce::String KinaVSTProcessor::TRASHER1_AMOUNT_ID = "trasher1_amount";
 const juce::String KinaVSTProcessor::TRASHER1_TONE_ID = "trasher1_tone";
+const juce::String KinaVSTProcessor::TRASHER1_ADAA_ID = "trasher1_adaa";
 
 const juce::String KinaVSTProcessor::TRASHER2_MODE_ID = "trasher2_mode";
 const juce::String KinaVSTProcessor::TRASHER2_AMOUNT_ID = "trasher2_amount";
 const juce::String KinaVSTProcessor::TRASHER2_TONE_ID = "trasher2_tone";
+const juce::String KinaVSTProcessor::TRASHER2_ADAA_ID = "trasher2_adaa";
 
 const juce::String KinaVSTProcessor::ECHO_TIME_ID = "echo_time";
 const juce::String KinaVSTProcessor::ECHO_FEEDBACK_ID = "echo_feedback";
 const juce::String KinaVSTProcessor::ECHO_AMOUNT_ID = "echo_amount";
 const juce::String KinaVSTProcessor::ECHO_SYNC_ID = "echo_sync";
+const juce::String KinaVSTProcessor::ECHO_INTERPOLATION_ID = "echo_interpolation";
 
 const juce::String KinaVSTProcessor::REVERB_SIZE_ID = "reverb_size";
 const juce::String KinaVSTProcessor::REVERB_DAMPING_ID = "reverb_damping";
 const juce::String KinaVSTProcessor::REVERB_WIDTH_ID = "reverb_width";
 const juce::String KinaVSTProcessor::REVERB_AMOUNT_ID = "reverb_amount";
+const juce::String KinaVSTProcessor::REVERB_ENGINE_ID = "reverb_engine";
+const juce::String KinaVSTProcessor::REVERB_RATE_ID = "reverb_rate";
 
 const juce::String KinaVSTProcessor::DRY_WET_ID = "dry_wet";
 const juce::String KinaVSTProcessor::OVERSAMPLING_ID = "oversampling";
+const juce::String KinaVSTProcessor::PARALLEL_OFFLINE_ID = "parallel_offline";
 
 KinaVSTProcessor::KinaVSTProcessor()
     : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
@@ -44,89 +51,57 @@ KinaVSTProcessor::KinaVSTProcessor()
     currentSampleRate = 44100.0;
     currentBlockSize = 512;
 
-    // Initialize all pointers to nullptr first
-    vcaLfo = nullptr;
-    vcfLfo = nullptr;
-    oversampling = nullptr;
+    // Look up every parameter once; the audio thread only ever reads the cached atomics
+    cacheParameterPointers();
 
     try {
-        // Initialize oscillators with basic sine wave
-        vcaLfo = std::make_unique<juce::dsp::Oscillator<float>>();
-        vcfLfo = std::make_unique<juce::dsp::Oscillator<float>>();
-        
-        if (vcaLfo && vcfLfo) {
-            vcaLfo->initialise([](float x) { return std::sin(x); });
-            vcfLfo->initialise([](float x) { return std::sin(x); });
-        }
+        // Initialize LFOs
+        vcaLfo.prepare(currentSampleRate);
+        vcfLfo.prepare(currentSampleRate);
 
         // Set up basic processing specs
         juce::dsp::ProcessSpec spec{
             currentSampleRate,
             static_cast<juce::uint32>(currentBlockSize),
-            static_cast<juce::uint32>(2) // Stereo
+            static_cast<juce::uint32>(getTotalNumOutputChannels()) // prepareToPlay() resizes for the host's bus
         };
 
-        // Initialize VCA
-        vca.reset();
-        vca.prepare(spec);
-
         // Initialize VCF
-        vcf.reset();
-        vcf.prepare(spec);
-        vcf.setType(juce::dsp::StateVariableTPTFilter<float>::Type::lowpass);
+        section.vcf.prepare(spec);
+        section.vcf.setType(FilterType::LowPass);
 
         // Initialize Trashers
-        trasher1.reset();
-        trasher2.reset();
-        trasher1.prepare(spec);
-        trasher2.prepare(spec);
+        section.trasher1.prepare(spec);
+        section.trasher2.prepare(spec);
 
         // Initialize Echo
-        echo.reset();
-        echo.prepare(spec);
-        echo.setMaximumDelayInSamples(static_cast<int>(currentSampleRate * 4.0)); // 4 seconds maximum delay
+        section.echo.prepare(spec, maxEchoSeconds);
 
         // Initialize Reverb
-        reverb.reset();
-        reverb.setSampleRate(currentSampleRate);
+        reverb.prepare(currentSampleRate);
     }
     catch (const std::exception&) {
         // If initialization fails, ensure everything is in a safe state
         vcaLfo.reset();
         vcfLfo.reset();
-        oversampling.reset();
-        vca.reset();
-        vcf.reset();
-        trasher1.reset();
-        trasher2.reset();
-        echo.reset();
+        section.oversampling = {};
+        section.reset();
         reverb.reset();
     }
 
-    // Add to class members
-    smoothedEchoTime.reset(currentSampleRate, 0.05);
-    smoothedEchoFeedback.reset(currentSampleRate, 0.05);
-    smoothedEchoAmount.reset(currentSampleRate, 0.05);
+    smoothed.reset(currentSampleRate, parameterPointers.load());
+
+    // Reconfiguration is built on the message thread and handed to the audio thread
+    startTimerHz(20);
 }
 
 KinaVSTProcessor::~KinaVSTProcessor()
 {
-    // Ensure clean shutdown
-    const juce::ScopedLock sl(lock);
-    
-    // Reset and release all resources
-    if (oversampling != nullptr)
-        oversampling->reset();
-    
-    vcaLfo.reset();
-    vcfLfo.reset();
-    oversampling.reset();
-    vca.reset();
-    vcf.reset();
-    trasher1.reset();
-    trasher2.reset();
-    echo.reset();
-    reverb.reset();
+    // Stop rebuilding before the handovers are torn down; they free whatever they still own
+    stopTimer();
+
+    // The jobs point back at us, so the threads have to stop first
+    workers.reset();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout KinaVSTProcessor::createParameterLayout()
@@ -196,79 +171,231 @@ juce::AudioProcessorValueTreeState::ParameterLayout KinaVSTProcessor::createPara
         juce::NormalisableRange<float>(0.0f, 1.0f), 1.0f));
     params.push_back(std::make_unique<juce::AudioParameterChoice>(OVERSAMPLING_ID, "Oversampling",
         juce::StringArray("Off", "2x", "4x", "8x"), 0));
+
+    // Parameters added since the first release go last, so existing parameter indices don't move
+    params.push_back(std::make_unique<juce::AudioParameterBool>(TRASHER1_ADAA_ID, "Trasher 1 Antialiasing", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(TRASHER2_ADAA_ID, "Trasher 2 Antialiasing", false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(ECHO_INTERPOLATION_ID, "Echo Interpolation",
+        juce::StringArray("Linear", "Lagrange", "Thiran"), 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(REVERB_ENGINE_ID, "Reverb Engine",
+        juce::StringArray("Classic", "FDN"), 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(REVERB_RATE_ID, "Reverb Rate",
+        juce::StringArray("Full", "Half", "Quarter"), 0));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(PARALLEL_OFFLINE_ID, "Parallel Offline Render", false));
     
     return { params.begin(), params.end() };
 }
 
+KinaVSTProcessor::ScratchSpace::ScratchSpace(int numChannelsToUse, int maxBlockSizeToUse, bool wholeBlocksToUse)
+    : numChannels(numChannelsToUse),
+      maxBlockSize(maxBlockSizeToUse),
+      wholeBlocks(wholeBlocksToUse),
+      arena([numChannelsToUse, maxBlockSizeToUse, wholeBlocksToUse]
+      {
+          // One sub-block's dry copy plus its control signals. The pipeline walks every block
+          // in sub-blocks, so this doesn't depend on the block size, unless whole blocks are
+          // rendered up front for the parallel path.
+          const auto numSamples = wholeBlocksToUse ? juce::jmax(maxSubBlockSize, static_cast<size_t>(maxBlockSizeToUse))
+                                                   : maxSubBlockSize;
+
+          return ScratchArena::bytesForBlock(static_cast<size_t>(numChannelsToUse), numSamples)
+               + ModulationBlock::numBuffers * ScratchArena::bytesForSamples(numSamples);
+      }())
+{
+    if (wholeBlocks)
+        subBlockModulation.resize((static_cast<size_t>(maxBlockSize) + maxSubBlockSize - 1) / maxSubBlockSize);
+}
+
+void KinaVSTProcessor::ChannelSection::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    const auto numChannels = static_cast<int>(spec.numChannels);
+
+    vcf.prepare(spec);
+    trasher1.prepare(spec);
+    trasher2.prepare(spec);
+    echo.prepare(spec, maxEchoSeconds);
+
+    // Every oversampling factor, so the parameter can change without a rebuild
+    try {
+        oversampling = createOversamplingBank(numChannels);
+    }
+    catch (const std::exception&) {
+        // If initialization fails, run without oversampling
+        oversampling = {};
+    }
+
+    oversampledControls.assign(numOversampledControls * maxSubBlockSize * maxOversamplingFactor, 0.0f);
+
+    // The dry path waits for the Trasher section's oversampling filters
+    dryDelay.prepare(numChannels, *std::max_element(oversampling.latencies.begin(), oversampling.latencies.end()));
+}
+
+void KinaVSTProcessor::ChannelSection::reset()
+{
+    vcf.reset();
+    trasher1.reset();
+    trasher2.reset();
+    dryDelay.reset();
+    echo.reset();
+
+    for (auto& processor : oversampling.processors)
+        if (processor != nullptr)
+            processor->reset();
+}
+
+void KinaVSTProcessor::ChannelSection::setParameters(const ParameterSnapshot& snapshot)
+{
+    vcf.setType(snapshot.vcfType);
+    echo.setInterpolation(snapshot.echoInterpolation);
+}
+
+void KinaVSTProcessor::ChannelSection::setOversamplingOrder(int order)
+{
+    if (auto& processor = oversampling.processors[static_cast<size_t>(order)])
+        processor->reset();
+
+    dryDelay.setDelay(oversampling.latencies[static_cast<size_t>(order)]);
+}
+
+template <typename Fn>
+void KinaVSTProcessor::forEachSection(Fn&& fn)
+{
+    fn(section);
+
+    for (auto& channelSection : channelSections)
+        fn(*channelSection);
+}
+
+void KinaVSTProcessor::switchOversamplingOrder(int order)
+{
+    activeOversamplingOrder = order;
+    forEachSection([order](ChannelSection& s) { s.setOversamplingOrder(order); });
+}
+
+void KinaVSTProcessor::cacheParameterPointers()
+{
+    auto& p = parameterPointers;
+
+    p.vcaLfoRate = parameters.getRawParameterValue(VCA_LFO_RATE_ID);
+    p.vcaLfoAmount = parameters.getRawParameterValue(VCA_LFO_AMOUNT_ID);
+    p.vcaLfoSync = parameters.getRawParameterValue(VCA_LFO_SYNC_ID);
+    p.vcaLfoShape = parameters.getRawParameterValue(VCA_LFO_SHAPE_ID);
+    p.vcaAmount = parameters.getRawParameterValue(VCA_AMOUNT_ID);
+
+    p.vcfType = parameters.getRawParameterValue(VCF_TYPE_ID);
+    p.vcfCutoff = parameters.getRawParameterValue(VCF_CUTOFF_ID);
+    p.vcfResonance = parameters.getRawParameterValue(VCF_RESONANCE_ID);
+    p.vcfLfoRate = parameters.getRawParameterValue(VCF_LFO_RATE_ID);
+    p.vcfLfoAmount = parameters.getRawParameterValue(VCF_LFO_AMOUNT_ID);
+    p.vcfLfoSync = parameters.getRawParameterValue(VCF_LFO_SYNC_ID);
+
+    p.trasher1Mode = parameters.getRawParameterValue(TRASHER1_MODE_ID);
+    p.trasher1Amount = parameters.getRawParameterValue(TRASHER1_AMOUNT_ID);
+    p.trasher1Tone = parameters.getRawParameterValue(TRASHER1_TONE_ID);
+    p.trasher1Adaa = parameters.getRawParameterValue(TRASHER1_ADAA_ID);
+
+    p.trasher2Mode = parameters.getRawParameterValue(TRASHER2_MODE_ID);
+    p.trasher2Amount = parameters.getRawParameterValue(TRASHER2_AMOUNT_ID);
+    p.trasher2Tone = parameters.getRawParameterValue(TRASHER2_TONE_ID);
+    p.trasher2Adaa = parameters.getRawParameterValue(TRASHER2_ADAA_ID);
+
+    p.echoTime = parameters.getRawParameterValue(ECHO_TIME_ID);
+    p.echoFeedback = parameters.getRawParameterValue(ECHO_FEEDBACK_ID);
+    p.echoAmount = parameters.getRawParameterValue(ECHO_AMOUNT_ID);
+    p.echoSync = parameters.getRawParameterValue(ECHO_SYNC_ID);
+
+    p.echoInterpolation = parameters.getRawParameterValue(ECHO_INTERPOLATION_ID);
+
+    p.reverbSize = parameters.getRawParameterValue(REVERB_SIZE_ID);
+    p.reverbDamping = parameters.getRawParameterValue(REVERB_DAMPING_ID);
+    p.reverbWidth = parameters.getRawParameterValue(REVERB_WIDTH_ID);
+    p.reverbAmount = parameters.getRawParameterValue(REVERB_AMOUNT_ID);
+    p.reverbEngine = parameters.getRawParameterValue(REVERB_ENGINE_ID);
+    p.reverbRate = parameters.getRawParameterValue(REVERB_RATE_ID);
+
+    p.dryWet = parameters.getRawParameterValue(DRY_WET_ID);
+    p.oversampling = parameters.getRawParameterValue(OVERSAMPLING_ID);
+    p.parallelOffline = parameters.getRawParameterValue(PARALLEL_OFFLINE_ID);
+}
+
 void KinaVSTProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     // Guard against invalid parameters
     if (sampleRate <= 0 || samplesPerBlock <= 0)
         return;
 
-    const juce::ScopedLock sl(lock);
-    
+    // The host doesn't call processBlock while we're in here, so objects can be replaced directly
+    const juce::ScopedLock lock(preparationLock);
+    isPrepared = false;
+
     try {
         // Update basic parameters
         currentSampleRate = sampleRate;
         currentBlockSize = samplesPerBlock;
 
-        // Create processing spec
+        // Create processing spec for the whole bus, mono up to 7.1
+        const auto numChannels = juce::jmax(1, getTotalNumInputChannels(), getTotalNumOutputChannels());
         juce::dsp::ProcessSpec spec{
             sampleRate,
             static_cast<juce::uint32>(samplesPerBlock),
-            static_cast<juce::uint32>(getTotalNumOutputChannels())
+            static_cast<juce::uint32>(numChannels)
         };
 
-        // Reset and prepare all processors
-        if (!vcaLfo || !vcfLfo) {
-            vcaLfo = std::make_unique<juce::dsp::Oscillator<float>>();
-            vcfLfo = std::make_unique<juce::dsp::Oscillator<float>>();
-            vcaLfo->initialise([](float x) { return std::sin(x); });
-            vcfLfo->initialise([](float x) { return std::sin(x); });
-        }
+        // Prepare LFOs
+        vcaLfo.prepare(sampleRate);
+        vcfLfo.prepare(sampleRate);
 
-        // Prepare oscillators
-        vcaLfo->reset();
-        vcfLfo->reset();
-        vcaLfo->prepare(spec);
-        vcfLfo->prepare(spec);
-        updateLfoWaveforms();
-
-        // Prepare VCA
-        vca.reset();
-        vca.prepare(spec);
-
-        // Prepare VCF
-        vcf.reset();
-        vcf.prepare(spec);
-
-        // Prepare Trashers
-        trasher1.reset();
-        trasher2.reset();
-        trasher1.prepare(spec);
-        trasher2.prepare(spec);
-        setupWaveShapers();
-        
-        // Prepare Echo
-        echo.reset();
-        echo.prepare(spec);
-        const auto maxDelaySamples = static_cast<int>(sampleRate * 4.0);
-        if (maxDelaySamples > 0) {
-            echo.setMaximumDelayInSamples(maxDelaySamples);
-        }
+        // Prepare VCF, Trashers, Echo and the Trashers' oversamplers
+        section.prepare(spec);
 
         // Prepare Reverb
-        reverb.reset();
-        reverb.setSampleRate(sampleRate);
+        reverb.prepare(sampleRate);
+        reverb.setLfeChannel(getChannelLayoutOfBus(false, 0).getChannelIndexForType(juce::AudioChannelSet::LFE));
+
+        analysisFeed.prepare(sampleRate);
+
+        // An offline render gets a mono copy of the section per channel and a thread for
+        // every channel but the one the host's thread runs. Realtime playback never uses them.
+        workers.reset();
+        channelJobs.clear();
+        channelSections.clear();
+        parallelActive = false;
+
+        const auto numWorkers = juce::jmin(numChannels, juce::SystemStats::getNumCpus()) - 1;
+        if (isNonRealtime() && numWorkers > 0)
+        {
+            auto monoSpec = spec;
+            monoSpec.numChannels = 1;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                channelSections.push_back(std::make_unique<ChannelSection>());
+                channelSections.back()->prepare(monoSpec);
+                channelJobs.push_back(std::make_unique<ChannelJob>(*this, static_cast<size_t>(ch)));
+            }
+
+            workers = std::make_unique<juce::ThreadPool>(numWorkers);
+        }
 
-        // Initialize oversampling last
-        initializeOversampling(samplesPerBlock);
+        // Scratch buffers for the whole audio path, so processBlock never allocates
+        scratch.reset(std::make_unique<ScratchSpace>(numChannels, samplesPerBlock, !channelSections.empty()));
+        largestHostBlockSize = 0;
 
-        // Reset smoothed parameters
-        smoothedEchoTime.reset(currentSampleRate, 0.05);
-        smoothedEchoFeedback.reset(currentSampleRate, 0.05);
-        smoothedEchoAmount.reset(currentSampleRate, 0.05);
+        oversamplingFade.reset(sampleRate, 0.01);
+        oversamplingFade.setCurrentAndTargetValue(1.0f);
+
+        switchOversamplingOrder(getRequestedOversamplingOrder());
+        setLatencySamples(section.oversampling.latencies[static_cast<size_t>(activeOversamplingOrder)]);
+
+        // Reset smoothed parameters, starting every ramp at its current value
+        smoothed.reset(currentSampleRate, parameterPointers.load());
+
+        // Input and output both have to stay quiet this long before the plugin sleeps
+        quietSamplesBeforeSleep = juce::roundToInt(0.05 * sampleRate);
+        quietSamples = 0;
+        sleeping = false;
+
+        isPrepared = true;
     }
     catch (const std::exception&) {
         // If preparation fails, reset everything to a safe state
@@ -278,47 +405,72 @@ void KinaVSTProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 
 void KinaVSTProcessor::releaseResources()
 {
-    const juce::ScopedLock sl(lock);
-    
-    // Reset all processors
-    if (oversampling != nullptr)
-        oversampling->reset();
-        
+    const juce::ScopedLock lock(preparationLock);
+    isPrepared = false;
+
+    // Not processing any more, so the oversampling, scratch buffers and offline threads can go straight away
+    workers.reset();
+    channelJobs.clear();
+    channelSections.clear();
+    parallelActive = false;
+
+    section.oversampling = {};
+    scratch.reset(nullptr);
+
     vcaLfo.reset();
     vcfLfo.reset();
-    vca.reset();
-    vcf.reset();
-    trasher1.reset();
-    trasher2.reset();
-    echo.reset();
+    section.reset();
     reverb.reset();
 }
 
 void KinaVSTProcessor::reset()
 {
-    const juce::ScopedLock sl(lock);
-    
-    if (vcaLfo) vcaLfo->reset();
-    if (vcfLfo) vcfLfo->reset();
-    vca.reset();
-    vcf.reset();
-    trasher1.reset();
-    trasher2.reset();
-    echo.reset();
+    vcaLfo.reset();
+    vcfLfo.reset();
+    forEachSection([](ChannelSection& s) { s.reset(); });
     reverb.reset();
-    if (oversampling) oversampling->reset();
+
+    quietSamples = 0;
+    sleeping = false;
+}
+
+bool KinaVSTProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Any bus from mono up to 7.1, as long as the output matches the input
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    return !output.isDisabled()
+        && output.size() <= static_cast<int>(maxBusChannels)
+        && output == layouts.getMainInputChannelSet();
 }
 
 void KinaVSTProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/)
 {
     juce::ScopedNoDenormals noDenormals;
-    const juce::ScopedLock sl(lock);
+
+    // Pick up anything the message thread has rebuilt since the last block
+    auto* scratchSpace = scratch.acquire();
     
     // Safety checks
-    if (!vcaLfo || !vcfLfo || buffer.getNumChannels() <= 0 || buffer.getNumSamples() <= 0) {
+    if (scratchSpace == nullptr
+        || buffer.getNumChannels() <= 0 || buffer.getNumSamples() <= 0
+        || buffer.getNumChannels() > scratchSpace->numChannels) {
         buffer.clear();
         return;
     }
+
+    const int requestedOversamplingOrder = getRequestedOversamplingOrder();
+    const int numSamples = buffer.getNumSamples();
+
+    // Hosts sometimes send more than they promised in prepareToPlay. Process those blocks in
+    // chunks that fit the buffers we have, and let the timer grow them for next time.
+    const int maxChunkSize = scratchSpace->maxBlockSize;
+
+    if (numSamples > largestHostBlockSize.load(std::memory_order_relaxed))
+        largestHostBlockSize.store(numSamples, std::memory_order_relaxed);
+
+    // Publishes the block's stage times when it goes out of scope
+    const StageProfiler::BlockScope blockProbe(profiler, numSamples, currentSampleRate);
     
     try {
         // Get current playhead info for sync features
@@ -327,19 +479,60 @@ void KinaVSTProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
         if (playHead != nullptr) {
             posInfo = playHead->getPosition();
         }
+
+        if (posInfo && posInfo->getBpm().hasValue())
+            lastHostBpm.store(*posInfo->getBpm(), std::memory_order_relaxed);
         
         // Create audio block
         juce::dsp::AudioBlock<float> block(buffer);
-        
-        // Process with oversampling if enabled and properly initialized
-        auto* oversamplingParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(OVERSAMPLING_ID));
-        if (oversamplingParam != nullptr && oversamplingParam->getIndex() > 0 && oversampling != nullptr) {
-            auto oversampledBlock = oversampling->processSamplesUp(block);
-            processBlockInternal(oversampledBlock, posInfo);
-            oversampling->processSamplesDown(block);
-        }
-        else {
-            processBlockInternal(block, posInfo);
+
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+        {
+            auto chunk = block.getSubBlock(static_cast<size_t>(start),
+                                           static_cast<size_t>(juce::jmin(maxChunkSize, numSamples - start)));
+            // Asleep, every section has already been reset and nothing is sounding, so a new
+            // factor can go straight in without a fade
+            if (sleeping && requestedOversamplingOrder != activeOversamplingOrder)
+            {
+                switchOversamplingOrder(requestedOversamplingOrder);
+                oversamplingFade.setCurrentAndTargetValue(1.0f);
+            }
+
+            // Once every tail has died away, silence in means silence out with no DSP at all
+            const bool inputSilent = isSilent(chunk);
+            if (inputSilent && sleeping)
+            {
+                chunk.clear();
+                continue;
+            }
+
+            sleeping = false;
+
+            // A new factor changes the latency of the whole output, and the new oversampler starts
+            // from a clean state, so fade the old one out, switch while silent, and fade back in.
+            // While a switch is waiting, go one sub-block at a time so it lands as soon as the fade
+            // is done, however large the host's blocks are.
+            for (size_t done = 0; done < chunk.getNumSamples();)
+            {
+                if (requestedOversamplingOrder != activeOversamplingOrder
+                    && !oversamplingFade.isSmoothing() && oversamplingFade.getCurrentValue() <= 0.0f)
+                    switchOversamplingOrder(requestedOversamplingOrder);
+
+                const bool switching = requestedOversamplingOrder != activeOversamplingOrder;
+                oversamplingFade.setTargetValue(switching ? 0.0f : 1.0f);
+
+                const auto remaining = chunk.getNumSamples() - done;
+                auto segment = chunk.getSubBlock(done, switching ? juce::jmin(maxSubBlockSize, remaining) : remaining);
+                done += segment.getNumSamples();
+
+                scratchSpace->arena.reset();
+                processBlockInternal(segment, posInfo, *scratchSpace, activeOversamplingOrder);
+
+                if (oversamplingFade.isSmoothing() || oversamplingFade.getCurrentValue() < 1.0f)
+                    segment.multiplyBy(oversamplingFade);
+            }
+
+            updateSleepState(inputSilent && isSilent(chunk), chunk.getNumSamples());
         }
     }
     catch (const std::exception&) {
@@ -349,271 +542,503 @@ void KinaVSTProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
 }
 
 void KinaVSTProcessor::processBlockInternal(juce::dsp::AudioBlock<float>& block,
-    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo)
+    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo, ScratchSpace& scratchSpace, int oversamplingOrder)
 {
     const auto numChannels = block.getNumChannels();
     const auto numSamples = block.getNumSamples();
     
-    // Create a dry copy
-    juce::AudioBuffer<float> dryBuffer(static_cast<int>(numChannels), static_cast<int>(numSamples));
-    for (size_t channel = 0; channel < numChannels; ++channel)
+    // Read every parameter once for the whole block
+    const auto snapshot = parameterPointers.load();
+    smoothed.setTargets(snapshot);
+    vcaLfo.setShape(snapshot.vcaLfoShape);
+    reverb.setEngine(snapshot.reverbEngine, snapshot.reverbRate);
+    reverb.setParameters(snapshot.reverbSize, snapshot.reverbDamping, snapshot.reverbWidth, snapshot.reverbAmount);
+
+    // The two paths keep separate state, so whichever one takes over starts from a clean slate
+    const bool parallel = canRunInParallel(snapshot, numChannels);
+    if (parallel != parallelActive)
     {
-        dryBuffer.copyFrom(static_cast<int>(channel), 0, block.getChannelPointer(channel), 
-            static_cast<int>(numSamples));
+        parallelActive = parallel;
+
+        if (parallel)
+            for (auto& channelSection : channelSections)
+                channelSection->reset();
+        else
+            section.reset();
     }
-    
-    // Get parameter values (thread-safe)
-    const float vcaLfoRate = parameters.getRawParameterValue(VCA_LFO_RATE_ID)->load();
-    const float vcaLfoAmount = parameters.getRawParameterValue(VCA_LFO_AMOUNT_ID)->load();
-    const bool vcaLfoSync = static_cast<bool>(parameters.getRawParameterValue(VCA_LFO_SYNC_ID)->load());
-    const float vcaAmount = parameters.getRawParameterValue(VCA_AMOUNT_ID)->load();
-    
-    const float vcfCutoff = parameters.getRawParameterValue(VCF_CUTOFF_ID)->load();
-    const float vcfResonance = parameters.getRawParameterValue(VCF_RESONANCE_ID)->load();
-    const float vcfLfoRate = parameters.getRawParameterValue(VCF_LFO_RATE_ID)->load();
-    const float vcfLfoAmount = parameters.getRawParameterValue(VCF_LFO_AMOUNT_ID)->load();
-    const bool vcfLfoSync = static_cast<bool>(parameters.getRawParameterValue(VCF_LFO_SYNC_ID)->load());
-    
-    // Get filter type
-    const auto filterType = static_cast<FilterType>(
-        static_cast<int>(parameters.getRawParameterValue(VCF_TYPE_ID)->load()));
-    
-    // Set filter type
-    switch (filterType)
+
+    if (parallel)
     {
-        case FilterType::LowPass:
-            vcf.setType(juce::dsp::StateVariableTPTFilter<float>::Type::lowpass);
-            break;
-        case FilterType::BandPass:
-            vcf.setType(juce::dsp::StateVariableTPTFilter<float>::Type::bandpass);
-            break;
-        case FilterType::HighPass:
-            vcf.setType(juce::dsp::StateVariableTPTFilter<float>::Type::highpass);
-            break;
+        processBlockInParallel(block, posInfo, scratchSpace, snapshot, oversamplingOrder);
+        return;
     }
-    
-    // Process each sample
-    for (size_t channel = 0; channel < numChannels; ++channel)
+
+    section.setParameters(snapshot);
+
+    // Scratch for one sub-block: the dry copy and every control signal
+    auto& arena = scratchSpace.arena;
+    auto dryBlock = arena.allocateBlock(numChannels, maxSubBlockSize);
+    bool allocated = dryBlock.getNumChannels() == numChannels;
+
+    ModulationBlock modulation;
+    for (auto* buffer : { &modulation.vcaGain, &modulation.vcfCutoffOctaves, &modulation.vcfResonance,
+                          &modulation.trasher1Amount, &modulation.trasher1Tone,
+                          &modulation.trasher2Amount, &modulation.trasher2Tone,
+                          &modulation.echoDelay, &modulation.echoFeedback, &modulation.echoAmount,
+                          &modulation.dryWet })
     {
-        auto* channelData = block.getChannelPointer(channel);
-        
-        for (size_t sample = 0; sample < numSamples; ++sample)
-        {
-            // Apply VCA modulation with improved scaling
-            float vcaModulation = getLfoValue(*vcaLfo, vcaLfoSync, vcaLfoRate, posInfo);
-            // Scale modulation to 0.5 to 2.0 range instead of 0.0 to 1.0
-            float vcaGain = juce::jmap(vcaModulation * vcaLfoAmount + (1.0f - vcaLfoAmount), 0.5f, 2.0f);
-            channelData[sample] *= vcaGain * juce::jlimit(0.0f, 1.0f, vcaAmount);
-            
-            // Add protection against extreme values
-            channelData[sample] = juce::jlimit(-1.0f, 1.0f, channelData[sample]);
-            
-            // Apply VCF modulation
-            float vcfModulation = getLfoValue(*vcfLfo, vcfLfoSync, vcfLfoRate, posInfo);
-
-            // Map LFO from [-1,1] to [1/factor, factor] where factor depends on amount
-            float modulationFactor = std::pow(2.0f, vcfLfoAmount * 4.0f); // 4.0f gives us 4 octaves range at amount=1.0
-            float frequencyMultiplier = std::exp2(vcfModulation * std::log2(modulationFactor));
-
-            // Apply the modulation multiplicatively to preserve musical frequency ratios
-            float modCutoff = vcfCutoff * frequencyMultiplier;
-
-            // Ensure we stay within safe frequency bounds
-            modCutoff = juce::jlimit(20.0f, 20000.0f, modCutoff);
-            vcf.setCutoffFrequency(modCutoff);
-            vcf.setResonance(vcfResonance);
-            channelData[sample] = vcf.processSample(static_cast<int>(channel), channelData[sample]);
-            
-            // Apply Trasher 1
-            const float trasher1Amount = parameters.getRawParameterValue(TRASHER1_AMOUNT_ID)->load();
-            const float trasher1Tone = parameters.getRawParameterValue(TRASHER1_TONE_ID)->load();
-            const auto trasher1Mode = static_cast<TrasherMode>(static_cast<int>(parameters.getRawParameterValue(TRASHER1_MODE_ID)->load()));
-            channelData[sample] = processDistortion(channelData[sample], trasher1Amount, trasher1Tone, trasher1Mode);
-            
-            // Apply Trasher 2
-            const float trasher2Amount = parameters.getRawParameterValue(TRASHER2_AMOUNT_ID)->load();
-            const float trasher2Tone = parameters.getRawParameterValue(TRASHER2_TONE_ID)->load();
-            const auto trasher2Mode = static_cast<TrasherMode>(static_cast<int>(parameters.getRawParameterValue(TRASHER2_MODE_ID)->load()));
-            channelData[sample] = processDistortion(channelData[sample], trasher2Amount, trasher2Tone, trasher2Mode);
-            
-            // Apply Echo
-            const float echoTime = parameters.getRawParameterValue(ECHO_TIME_ID)->load();
-            const float echoFeedback = parameters.getRawParameterValue(ECHO_FEEDBACK_ID)->load();
-            const float echoAmount = parameters.getRawParameterValue(ECHO_AMOUNT_ID)->load();
-            const bool echoSync = static_cast<bool>(parameters.getRawParameterValue(ECHO_SYNC_ID)->load());
-            
-            // Update smoothed values
-            smoothedEchoTime.setTargetValue(echoTime);
-            smoothedEchoFeedback.setTargetValue(echoFeedback);
-            smoothedEchoAmount.setTargetValue(echoAmount);
-            
-            float delayInSamples;
-            if (echoSync && posInfo && posInfo->getBpm().hasValue())
-            {
-                const double samplesPerBeat = (60.0 / *posInfo->getBpm()) * currentSampleRate;
-                // Map time parameter to musical divisions (e.g., 1/4, 1/8, 1/16 notes)
-                const float beatDivisions[] = { 0.25f, 0.375f, 0.5f, 0.75f, 1.0f, 1.5f, 2.0f };
-                const float mappedTime = juce::jmap(smoothedEchoTime.getNextValue(), 0.01f, 2.0f, 
-                                                  beatDivisions[0], beatDivisions[std::size(beatDivisions)-1]);
-                delayInSamples = static_cast<float>(samplesPerBeat * mappedTime);
-            }
-            else
+        *buffer = arena.allocateSamples(maxSubBlockSize);
+        allocated = allocated && *buffer != nullptr;
+    }
+
+    // Only happens if the scratch space was sized for fewer channels than the host sent
+    if (!allocated)
+    {
+        block.clear();
+        return;
+    }
+
+    auto& times = profiler.getBlockTimes();
+
+    // Each stage runs over a whole sub-block before the next one starts
+    for (size_t start = 0; start < numSamples; start += maxSubBlockSize)
+    {
+        const auto subBlockSize = juce::jmin(maxSubBlockSize, numSamples - start);
+        auto subBlock = block.getSubBlock(start, subBlockSize);
+        auto dry = dryBlock.getSubBlock(0, subBlockSize);
+        StageProfiler::measure(times, StageProfiler::Stage::Dry, [&] { dry.copyFrom(subBlock); });
+
+        modulation.numSamples = subBlockSize;
+        StageProfiler::measure(times, StageProfiler::Stage::Modulation, [&] { renderModulation(modulation, snapshot, posInfo); });
+
+        processSection(section, subBlock, dry, modulation, snapshot, oversamplingOrder);
+        StageProfiler::measure(times, StageProfiler::Stage::Reverb, [&] { reverb.process(subBlock); });
+        StageProfiler::measure(times, StageProfiler::Stage::Mix, [&] { MixStage::process(subBlock, dry, modulation.dryWet); });
+
+        analysisFeed.process(dry, subBlock, modulation.vcaGain, modulation.vcfCutoffOctaves);
+    }
+
+    profiler.collect(section.stageTimes);
+}
+
+bool KinaVSTProcessor::canRunInParallel(const ParameterSnapshot& snapshot, size_t numChannels) const
+{
+    // Realtime playback always runs single-threaded, whatever the parameter says
+    return snapshot.parallelOffline && isNonRealtime() && workers != nullptr
+        && numChannels > 1 && numChannels <= channelSections.size();
+}
+
+void KinaVSTProcessor::processBlockInParallel(juce::dsp::AudioBlock<float>& block,
+    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo, ScratchSpace& scratchSpace,
+    const ParameterSnapshot& snapshot, int oversamplingOrder)
+{
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+    auto& arena = scratchSpace.arena;
+    jassert(scratchSpace.wholeBlocks);
+
+    // The dry copy and every sub-block's control signals, rendered in the same steps as the
+    // single-threaded path so the output matches it bit for bit
+    auto& times = profiler.getBlockTimes();
+    auto dryBlock = arena.allocateBlock(numChannels, numSamples);
+    const auto numSubBlocks = (numSamples + maxSubBlockSize - 1) / maxSubBlockSize;
+    bool allocated = dryBlock.getNumChannels() == numChannels && numSubBlocks <= scratchSpace.subBlockModulation.size();
+
+    ModulationBlock whole;
+    for (auto* buffer : { &whole.vcaGain, &whole.vcfCutoffOctaves, &whole.vcfResonance,
+                          &whole.trasher1Amount, &whole.trasher1Tone,
+                          &whole.trasher2Amount, &whole.trasher2Tone,
+                          &whole.echoDelay, &whole.echoFeedback, &whole.echoAmount,
+                          &whole.dryWet })
+    {
+        *buffer = arena.allocateSamples(numSamples);
+        allocated = allocated && *buffer != nullptr;
+    }
+
+    // Only happens if the scratch space was sized for a smaller block than this one
+    if (!allocated)
+    {
+        block.clear();
+        return;
+    }
+
+    StageProfiler::measure(times, StageProfiler::Stage::Dry, [&] { dryBlock.copyFrom(block); });
+    auto* subBlocks = scratchSpace.subBlockModulation.data();
+
+    for (size_t s = 0; s < numSubBlocks; ++s)
+    {
+        const auto start = s * maxSubBlockSize;
+        auto& modulation = subBlocks[s];
+        modulation = whole;
+        modulation.numSamples = juce::jmin(maxSubBlockSize, numSamples - start);
+
+        for (auto* buffer : { &modulation.vcaGain, &modulation.vcfCutoffOctaves, &modulation.vcfResonance,
+                              &modulation.trasher1Amount, &modulation.trasher1Tone,
+                              &modulation.trasher2Amount, &modulation.trasher2Tone,
+                              &modulation.echoDelay, &modulation.echoFeedback, &modulation.echoAmount,
+                              &modulation.dryWet })
+            *buffer += start;
+
+        StageProfiler::measure(times, StageProfiler::Stage::Modulation, [&] { renderModulation(modulation, snapshot, posInfo); });
+    }
+
+    for (auto& channelSection : channelSections)
+        channelSection->setParameters(snapshot);
+
+    // Every channel but the first goes to a worker; this thread takes the first, then waits
+    parallelChunk = { block, dryBlock, subBlocks, &snapshot, oversamplingOrder };
+
+    for (size_t ch = 1; ch < numChannels; ++ch)
+        workers->addJob(channelJobs[ch].get(), false);
+
+    processChannelInParallel(0);
+
+    for (size_t ch = 1; ch < numChannels; ++ch)
+        workers->waitForJobToFinish(channelJobs[ch].get(), -1);
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+        profiler.collect(channelSections[ch]->stageTimes);
+
+    // The reverb mixes the channels, so from here on it's one thread again
+    for (size_t s = 0; s < numSubBlocks; ++s)
+    {
+        const auto start = s * maxSubBlockSize;
+        const auto& modulation = subBlocks[s];
+        auto subBlock = block.getSubBlock(start, modulation.numSamples);
+
+        StageProfiler::measure(times, StageProfiler::Stage::Reverb, [&] { reverb.process(subBlock); });
+        const auto dry = dryBlock.getSubBlock(start, modulation.numSamples);
+        StageProfiler::measure(times, StageProfiler::Stage::Mix, [&] { MixStage::process(subBlock, dry, modulation.dryWet); });
+
+        analysisFeed.process(dry, subBlock, modulation.vcaGain, modulation.vcfCutoffOctaves);
+    }
+}
+
+void KinaVSTProcessor::processChannelInParallel(size_t channel)
+{
+    const auto& chunk = parallelChunk;
+    auto& channelSection = *channelSections[channel];
+    const auto block = chunk.block.getSingleChannelBlock(channel);
+    const auto dry = chunk.dry.getSingleChannelBlock(channel);
+
+    for (size_t start = 0, s = 0; start < block.getNumSamples(); start += maxSubBlockSize, ++s)
+    {
+        const auto& modulation = chunk.modulation[s];
+        processSection(channelSection, block.getSubBlock(start, modulation.numSamples),
+                       dry.getSubBlock(start, modulation.numSamples), modulation, *chunk.snapshot, chunk.oversamplingOrder);
+    }
+}
+
+void KinaVSTProcessor::processSection(ChannelSection& channelSection, const juce::dsp::AudioBlock<float>& subBlock,
+    const juce::dsp::AudioBlock<float>& dry, const ModulationBlock& modulation, const ParameterSnapshot& snapshot,
+    int oversamplingOrder) const
+{
+    using Stage = StageProfiler::Stage;
+    const auto subBlockSize = subBlock.getNumSamples();
+    auto& times = channelSection.stageTimes;
+
+    StageProfiler::measure(times, Stage::Dry, [&] { channelSection.dryDelay.process(dry); });
+    StageProfiler::measure(times, Stage::Vca, [&] { vca.process(subBlock, modulation.vcaGain); });
+
+    StageProfiler::measure(times, Stage::Vcf, [&] {
+        if (modulation.vcfIsStatic)
+            channelSection.vcf.process(subBlock, modulation.vcfCutoffOctaves[0], modulation.vcfResonance[0]);
+        else
+            channelSection.vcf.process(subBlock, modulation.vcfCutoffOctaves, modulation.vcfResonance);
+    });
+
+    // Only the waveshapers create harmonics that can alias, so only they run oversampled.
+    // Null when oversampling is off or failed to initialize.
+    if (auto* oversampler = channelSection.oversampling.processors[static_cast<size_t>(oversamplingOrder)].get())
+    {
+        // The Trasher controls again at the oversampled rate: amount 1, tone 1, amount 2, tone 2
+        const size_t factor = oversampler->getOversamplingFactor();
+        const float* controls[] = { modulation.trasher1Amount, modulation.trasher1Tone,
+                                    modulation.trasher2Amount, modulation.trasher2Tone };
+        float* oversampledControls[numOversampledControls];
+
+        // Holding the controls for the oversampled rate counts as part of going up
+        auto oversampledBlock = StageProfiler::measure(times, Stage::OversampleUp, [&] {
+            for (int c = 0; c < numOversampledControls; ++c)
             {
-                delayInSamples = static_cast<float>(currentSampleRate * smoothedEchoTime.getNextValue());
+                oversampledControls[c] = channelSection.oversampledControls.data() + static_cast<size_t>(c) * maxSubBlockSize * maxOversamplingFactor;
+
+                for (size_t i = 0; i < subBlockSize; ++i)
+                    std::fill_n(oversampledControls[c] + i * factor, factor, controls[c][i]);
             }
-            
-            // Ensure delay time is within bounds
-            delayInSamples = juce::jlimit(1.0f, static_cast<float>(echo.getMaximumDelayInSamples()), delayInSamples);
-            echo.setDelay(delayInSamples);
-            
-            // Get the delayed sample
-            const float delayedSample = echo.popSample(static_cast<int>(channel));
-            
-            // Calculate the feedback input with smoothed feedback
-            const float feedbackInput = channelData[sample] + (delayedSample * smoothedEchoFeedback.getNextValue());
-            
-            // Push the feedback signal into the delay line
-            echo.pushSample(static_cast<int>(channel), feedbackInput);
-            
-            // Mix the original signal with the delayed signal (don't replace it)
-            const float dry = channelData[sample];
-            const float wet = delayedSample;
-            channelData[sample] = dry + (wet * smoothedEchoAmount.getNextValue());
-        }
+
+            return oversampler->processSamplesUp(subBlock);
+        });
+
+        StageProfiler::measure(times, Stage::Trasher1, [&] {
+            channelSection.trasher1.process(oversampledBlock, oversampledControls[0], oversampledControls[1], snapshot.trasher1Mode, snapshot.trasher1Adaa);
+        });
+        StageProfiler::measure(times, Stage::Trasher2, [&] {
+            channelSection.trasher2.process(oversampledBlock, oversampledControls[2], oversampledControls[3], snapshot.trasher2Mode, snapshot.trasher2Adaa);
+        });
+        StageProfiler::measure(times, Stage::OversampleDown, [&] { oversampler->processSamplesDown(subBlock); });
     }
-    
-    // Apply Reverb
-    juce::Reverb::Parameters params;
-    params.roomSize = parameters.getRawParameterValue(REVERB_SIZE_ID)->load();
-    params.damping = parameters.getRawParameterValue(REVERB_DAMPING_ID)->load();
-    params.width = parameters.getRawParameterValue(REVERB_WIDTH_ID)->load();
-    params.wetLevel = parameters.getRawParameterValue(REVERB_AMOUNT_ID)->load();
-    params.dryLevel = 1.0f - params.wetLevel;
-    reverb.setParameters(params);
-    
-    // Process reverb
-    if (numChannels > 1)
+    else
     {
-        reverb.processStereo(block.getChannelPointer(0), block.getChannelPointer(1), 
-            static_cast<int>(numSamples));
+        StageProfiler::measure(times, Stage::Trasher1, [&] {
+            channelSection.trasher1.process(subBlock, modulation.trasher1Amount, modulation.trasher1Tone, snapshot.trasher1Mode, snapshot.trasher1Adaa);
+        });
+        StageProfiler::measure(times, Stage::Trasher2, [&] {
+            channelSection.trasher2.process(subBlock, modulation.trasher2Amount, modulation.trasher2Tone, snapshot.trasher2Mode, snapshot.trasher2Adaa);
+        });
+    }
+
+    StageProfiler::measure(times, Stage::Echo, [&] {
+        channelSection.echo.process(subBlock, modulation.echoDelay, modulation.echoFeedback, modulation.echoAmount);
+    });
+}
+
+void KinaVSTProcessor::renderModulation(const ModulationBlock& modulation, const ParameterSnapshot& snapshot,
+    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo)
+{
+    const bool echoSynced = snapshot.echoSync && posInfo && posInfo->getBpm().hasValue();
+    const double samplesPerBeat = echoSynced ? (60.0 / *posInfo->getBpm()) * currentSampleRate : 0.0;
+    const float maxDelaySamples = section.echo.getMaximumDelayInSamples();
+
+    // Both LFOs render straight into the buffers they modulate, which are then mapped in place
+    renderLfo(vcaLfo, smoothed.vcaLfoRate, snapshot.vcaLfoSync, posInfo, modulation.vcaGain, modulation.numSamples);
+
+    // With no depth the VCF LFO only has to keep time, and the cutoff may not move at all
+    const bool vcfLfoOff = !smoothed.vcfLfoAmount.isSmoothing() && smoothed.vcfLfoAmount.getTargetValue() <= 0.0f;
+    modulation.vcfIsStatic = vcfLfoOff && !smoothed.vcfCutoffOctaves.isSmoothing() && !smoothed.vcfResonance.isSmoothing();
+
+    if (vcfLfoOff)
+    {
+        advanceLfo(vcfLfo, smoothed.vcfLfoRate, snapshot.vcfLfoSync, posInfo, modulation.numSamples);
+        std::fill_n(modulation.vcfCutoffOctaves, modulation.numSamples, 0.0f);
     }
     else
     {
-        reverb.processMono(block.getChannelPointer(0), static_cast<int>(numSamples));
+        renderLfo(vcfLfo, smoothed.vcfLfoRate, snapshot.vcfLfoSync, posInfo, modulation.vcfCutoffOctaves, modulation.numSamples);
     }
-    
-    // Mix dry/wet
-    const float dryWet = parameters.getRawParameterValue(DRY_WET_ID)->load();
-    for (size_t channel = 0; channel < numChannels; ++channel)
+
+    for (size_t i = 0; i < modulation.numSamples; ++i)
     {
-        auto* wetData = block.getChannelPointer(channel);
-        const auto* dryData = dryBuffer.getReadPointer(static_cast<int>(channel));
-        
-        for (size_t sample = 0; sample < numSamples; ++sample)
+        // VCA modulation with improved scaling
+        const float vcaLfoAmount = smoothed.vcaLfoAmount.getNextValue();
+        const float vcaAmount = smoothed.vcaAmount.getNextValue();
+        const float vcaModulation = modulation.vcaGain[i];
+        // Scale modulation to 0.5 to 2.0 range instead of 0.0 to 1.0
+        modulation.vcaGain[i] = juce::jmap(vcaModulation * vcaLfoAmount + (1.0f - vcaLfoAmount), 0.5f, 2.0f)
+                              * juce::jlimit(0.0f, 1.0f, vcaAmount);
+
+        // VCF modulation
+        const float vcfLfoAmount = smoothed.vcfLfoAmount.getNextValue();
+        const float vcfModulation = modulation.vcfCutoffOctaves[i];
+
+        // The cutoff is in octaves, so the LFO simply adds up to +/-4 octaves at amount=1.0,
+        // and the result stays within safe frequency bounds
+        const float cutoffOctaves = smoothed.vcfCutoffOctaves.getNextValue() + vcfModulation * vcfLfoAmount * 4.0f;
+        modulation.vcfCutoffOctaves[i] = juce::jlimit(VcfStage::minCutoffOctaves, VcfStage::maxCutoffOctaves, cutoffOctaves);
+        modulation.vcfResonance[i] = smoothed.vcfResonance.getNextValue();
+
+        // Trashers
+        modulation.trasher1Amount[i] = smoothed.trasher1Amount.getNextValue();
+        modulation.trasher1Tone[i] = smoothed.trasher1Tone.getNextValue();
+        modulation.trasher2Amount[i] = smoothed.trasher2Amount.getNextValue();
+        modulation.trasher2Tone[i] = smoothed.trasher2Tone.getNextValue();
+
+        // Echo delay time
+        const float echoTime = smoothed.echoTime.getNextValue();
+        float delayInSamples;
+        if (echoSynced)
+        {
+            delayInSamples = static_cast<float>(samplesPerBeat * getEchoBeats(echoTime));
+        }
+        else
         {
-            wetData[sample] = dryData[sample] * (1.0f - dryWet) + wetData[sample] * dryWet;
+            delayInSamples = static_cast<float>(currentSampleRate * echoTime);
         }
+        
+        // Ensure delay time is within bounds
+        modulation.echoDelay[i] = juce::jlimit(EchoStage::minimumDelayInSamples, maxDelaySamples, delayInSamples);
+        modulation.echoFeedback[i] = smoothed.echoFeedback.getNextValue();
+        modulation.echoAmount[i] = smoothed.echoAmount.getNextValue();
+
+        modulation.dryWet[i] = smoothed.dryWet.getNextValue();
     }
-    
-    // Update LFO waveforms if changed
-    updateLfoWaveforms();
 }
 
-float KinaVSTProcessor::getLfoValue(juce::dsp::Oscillator<float>& lfo, bool sync, float rate,
-    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo)
+float KinaVSTProcessor::getEchoBeats(float echoTime) noexcept
+{
+    // Map time parameter to musical divisions (e.g., 1/4, 1/8, 1/16 notes)
+    const float beatDivisions[] = { 0.25f, 0.375f, 0.5f, 0.75f, 1.0f, 1.5f, 2.0f };
+    return juce::jmap(echoTime, 0.01f, 2.0f, beatDivisions[0], beatDivisions[std::size(beatDivisions)-1]);
+}
+
+void KinaVSTProcessor::renderLfo(Lfo& lfo, SmoothedParameters::Multiplicative& rate, bool sync,
+    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo, float* output, size_t numSamples)
 {
     if (sync && posInfo && posInfo->getBpm().hasValue())
     {
-        const double samplesPerBeat = (60.0 / *posInfo->getBpm()) * currentSampleRate;
-        lfo.setFrequency(static_cast<float>(1.0 / (samplesPerBeat / currentSampleRate)));
+        // One cycle per beat; keep the rate ramp moving so it's in the right place if sync is turned off
+        rate.skip(static_cast<int>(numSamples));
+        lfo.process(static_cast<float>(*posInfo->getBpm() / 60.0), output, numSamples);
+    }
+    else if (!rate.isSmoothing())
+    {
+        lfo.process(rate.getTargetValue(), output, numSamples);
     }
     else
     {
-        lfo.setFrequency(rate);
+        for (size_t i = 0; i < numSamples; ++i)
+            output[i] = rate.getNextValue();
+
+        lfo.process(output, output, numSamples);
     }
-    
-    return lfo.processSample(0.0f);
 }
 
-float KinaVSTProcessor::processDistortion(float sample, float amount, float tone, TrasherMode mode)
+void KinaVSTProcessor::advanceLfo(Lfo& lfo, SmoothedParameters::Multiplicative& rate, bool sync,
+    const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo, size_t numSamples)
 {
-    if (amount <= 0.0f)
-        return sample;
-        
-    float processed;
-    /*
+    if (sync && posInfo && posInfo->getBpm().hasValue())
+    {
+        rate.skip(static_cast<int>(numSamples));
+        lfo.advance(static_cast<float>(*posInfo->getBpm() / 60.0), numSamples);
+    }
+    else if (!rate.isSmoothing())
+    {
+        lfo.advance(rate.getTargetValue(), numSamples);
+    }
+    else
+    {
+        // Over one sub-block the mean of the two ends is close enough
+        const auto startRate = rate.getCurrentValue();
+        rate.skip(static_cast<int>(numSamples));
+        lfo.advance(0.5f * (startRate + rate.getCurrentValue()), numSamples);
+    }
+}
 
-    switch (mode)
+void KinaVSTProcessor::updateSleepState(bool quiet, size_t numSamples)
+{
+    quietSamples = quiet ? quietSamples + static_cast<int>(numSamples) : 0;
+
+    if (quietSamples < quietSamplesBeforeSleep || !reverb.isTailSilent())
+        return;
+
+    if (parallelActive)
     {
-        case TrasherMode::Fuzz:
-            processed = std::tanh(sample * (1.0f + 40.0f * amount));
-            break;
-            
-        case TrasherMode::Scream:
-            processed = (sample >= 0.0f) ? 1.0f - std::exp(-sample * amount * 3.0f)
-                                       : -1.0f + std::exp(sample * amount * 3.0f);
-            break;
-    }
-    */
-    // Configure the waveshaping function based on the mode
-     // Use the already configured waveshapers
-    switch (mode)
+        for (auto& channelSection : channelSections)
+            if (!channelSection->echo.isTailSilent())
+                return;
+    }
+    else if (!section.echo.isTailSilent())
     {
-        case TrasherMode::Fuzz:
-            processed = trasher1.processSample(sample * (1.0f + 40.0f * amount));
-            break;
-            
-        case TrasherMode::Scream:
-            processed = trasher2.processSample(sample * amount * 3.0f);
-            break;
+        return;
     }
-    
-    return processed * (1.0f - tone) + sample * tone;
+
+    // Whatever is left in the chain is below the silence threshold, so the next sound can
+    // start from a clean slate. Resetting a section only touches small filter states: the echo
+    // marks its ring stale rather than clearing it. The reverb's tanks are left as they are,
+    // since clearing them would cost megabytes of writes to remove nothing audible.
+    sleeping = true;
+    forEachSection([](ChannelSection& s) { s.reset(); });
+}
+
+double KinaVSTProcessor::getTailLengthSeconds() const
+{
+    // The echo's repeats then run through the reverb, so the tails add up
+    const auto s = parameterPointers.load();
+    const auto echoSeconds = s.echoSync ? getEchoBeats(s.echoTime) * 60.0 / juce::jmax(1.0, lastHostBpm.load(std::memory_order_relaxed))
+                                        : static_cast<double>(s.echoTime);
+
+    return EchoStage::getTailLengthSeconds(juce::jmin(echoSeconds, maxEchoSeconds), s.echoFeedback, s.echoAmount)
+         + ReverbStage::getTailLengthSeconds(s.reverbSize, s.reverbAmount);
+}
+
+void KinaVSTProcessor::timerCallback()
+{
+    // Free anything the audio thread has swapped out since the last tick
+    scratch.collectGarbage();
+
+    if (!isPrepared)
+        return;
+
+    updateBlockSize();
+    updateLatency();
+}
+
+int KinaVSTProcessor::getRequestedOversamplingOrder() const noexcept
+{
+    // order: 0=Off, 1=2x, 2=4x, 3=8x
+    const auto order = static_cast<int>(parameterPointers.oversampling->load(std::memory_order_relaxed));
+    return juce::jlimit(0, numOversamplingOrders - 1, order);
 }
 
-void KinaVSTProcessor::updateOversamplingSettings()
+void KinaVSTProcessor::updateLatency()
 {
-    auto* param = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(OVERSAMPLING_ID));
-    if (param != nullptr)
+    // The latency table belongs to the oversampling bank, which prepare and release replace
+    const juce::ScopedTryLock lock(preparationLock);
+    if (!lock.isLocked() || !isPrepared)
+        return;
+
+    // The audio thread switches factor by itself; the host just needs to hear about the new latency
+    const int latency = section.oversampling.latencies[static_cast<size_t>(getRequestedOversamplingOrder())];
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void KinaVSTProcessor::updateBlockSize()
+{
+    // If prepareToPlay or releaseResources is rebuilding right now, leave it to the next tick
+    const juce::ScopedTryLock lock(preparationLock);
+    if (!lock.isLocked() || !isPrepared)
+        return;
+
+    const int largest = largestHostBlockSize.load();
+    if (largest <= currentBlockSize)
+        return;
+
+    // The host has sent a bigger block than it promised. Until the bigger buffers
+    // arrive the audio thread splits those blocks into chunks, so this is only
+    // about avoiding the extra per-chunk overhead.
+    currentBlockSize = largest;
+
+    scratch.publish(std::make_unique<ScratchSpace>(
+        juce::jmax(1, getTotalNumInputChannels(), getTotalNumOutputChannels()), largest, !channelSections.empty()));
+}
+
+KinaVSTProcessor::OversamplingBank KinaVSTProcessor::createOversamplingBank(int numChannels)
+{
+    OversamplingBank bank;
+
+    for (int order = 1; order < numOversamplingOrders; ++order)
     {
-        // First, reset the existing oversampling
-        oversampling.reset();
-        
-        int factor = 1 << param->getIndex(); // 2^index: 1, 2, 4, 8
-        if (factor > 1)
-        {
-            try
-            {
-                // Create new oversampling object with new factor
-                auto newOversampling = std::make_unique<juce::dsp::Oversampling<float>>(
-                    2, // num channels
-                    param->getIndex(), // order: 1=2x, 2=4x, 3=8x
-                    juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
-                    true, // true = better quality
-                    false // don't process the extra channels in parallel
-                );
-                
-                // Initialize the new oversampling object
-                newOversampling->initProcessing(static_cast<size_t>(currentBlockSize));
-                
-                // Replace the old oversampling object
-                oversampling = std::move(newOversampling);
-            }
-            catch (const std::exception& e)
-            {
-                // If initialization fails, reset oversampling and parameter
-                oversampling.reset();
-                param->setValueNotifyingHost(0.0f); // Set back to "Off"
-            }
-        }
+        auto processor = std::make_unique<juce::dsp::Oversampling<float>>(
+            static_cast<size_t>(numChannels),
+            static_cast<size_t>(order),
+            juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+            true,  // Use maximum quality
+            true   // Use integer latency compensation
+        );
+
+        // The Trasher section runs one sub-block at a time
+        processor->initProcessing(maxSubBlockSize);
+
+        bank.latencies[static_cast<size_t>(order)] = juce::roundToInt(processor->getLatencyInSamples());
+        bank.processors[static_cast<size_t>(order)] = std::move(processor);
     }
+
+    return bank;
 }
 
 void KinaVSTProcessor::randomizeParameters()
 {
     for (auto* param : getParameters())
     {
-        if (param->getName(32) != "Dry/Wet") // Don't randomize dry/wet
+        // Don't randomize dry/wet, or the quality and threading settings: a new oversampling
+        // factor fades the whole output out and in and changes the latency, and the reverb
+        // rate and offline threading only trade CPU for quality
+        const auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+        const bool isSetting = withID != nullptr
+            && (withID->paramID == OVERSAMPLING_ID || withID->paramID == REVERB_RATE_ID || withID->paramID == PARALLEL_OFFLINE_ID);
+
+        if (param->getName(32) != "Dry/Wet" && !isSetting)
         {
             if (auto* rangedParam = dynamic_cast<juce::RangedAudioParameter*>(param))
             {
@@ -640,97 +1065,9 @@ void KinaVSTProcessor::setStateInformation(const void* data, int sizeInBytes)
 
 juce::AudioProcessorEditor* KinaVSTProcessor::createEditor()
 {
-    return new juce::GenericAudioProcessorEditor(*this);
-}
-
-void KinaVSTProcessor::updateLfoWaveforms()
-{
-    if (auto* vcaLfoShapeParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(VCA_LFO_SHAPE_ID)))
-    {
-        switch (vcaLfoShapeParam->getIndex())
-        {
-            case 0: // Sine
-                vcaLfo->initialise([](float x) { return std::sin(x); });
-                break;
-            case 1: // Triangle
-                vcaLfo->initialise([](float x) 
-                { 
-                    x = std::fmod(x + juce::MathConstants<float>::pi, 2.0f * juce::MathConstants<float>::pi);
-                    return 2.0f * std::abs(x / juce::MathConstants<float>::pi - 1.0f) - 1.0f;
-                });
-                break;
-            case 2: // Saw
-                vcaLfo->initialise([](float x)
-                {
-                    x = std::fmod(x + juce::MathConstants<float>::pi, 2.0f * juce::MathConstants<float>::pi);
-                    return x / juce::MathConstants<float>::pi - 1.0f;
-                });
-                break;
-            case 3: // Square
-                vcaLfo->initialise([](float x) { return std::sin(x) >= 0.0f ? 1.0f : -1.0f; });
-                break;
-            case 4: // Random
-                vcaLfo->initialise([this](float x)
-                {
-                    static float lastValue = 0.0f;
-                    static float phase = 0.0f;
-                    
-                    x = std::fmod(x, 2.0f * juce::MathConstants<float>::pi);
-                    if (x < phase)
-                    {
-                        lastValue = random.nextFloat() * 2.0f - 1.0f;
-                    }
-                    phase = x;
-                    return lastValue;
-                });
-                break;
-        }
-    }
+    return new KinaVSTEditor(*this);
 }
 
-void KinaVSTProcessor::initializeOversampling(int samplesPerBlock)
-{
-    auto* oversamplingParam = dynamic_cast<juce::AudioParameterChoice*>(parameters.getParameter(OVERSAMPLING_ID));
-    if (oversamplingParam != nullptr) {
-        // Don't reset to "Off" - let the parameter keep its value
-        oversampling.reset();
-        
-        try {
-            const int factor = 1 << oversamplingParam->getIndex();
-            if (factor > 1) {
-                oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
-                    getTotalNumOutputChannels(),
-                    oversamplingParam->getIndex(),
-                    juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
-                    true,  // Use maximum quality
-                    true   // Use integer latency compensation
-                );
-                
-                if (oversampling) {
-                    oversampling->initProcessing(static_cast<size_t>(samplesPerBlock));
-                }
-            }
-        }
-        catch (const std::exception&) {
-            oversampling.reset();
-            oversamplingParam->setValueNotifyingHost(0.0f);
-        }
-    }
-}
-
-void KinaVSTProcessor::setupWaveShapers()
-{
-    // Set up Fuzz waveshaper
-    trasher1.functionToUse = [](float x) {
-        return std::tanh(x);
-    };
-    
-    // Set up Scream waveshaper
-    trasher2.functionToUse = [](float x) {
-        return (x >= 0.0f) ? 1.0f - std::exp(-x)
-                          : -1.0f + std::exp(x);
-    };
-}
 //==============================================================================
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
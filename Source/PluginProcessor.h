@@ -4,37 +4,16 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 
-enum class FilterType
-{
-    LowPass,
-    BandPass,
-    HighPass
-};
-
-enum class LfoShape
-{
-    Sine,
-    Triangle,
-    Saw,
-    Square,
-    Random
-};
-
-enum class TrasherMode
-{
-    Fuzz,
-    Scream
-};
-
-enum class OversamplingFactor
-{
-    None = 1,
-    X2 = 2,
-    X4 = 4,
-    X8 = 8
-};
+#include "AnalysisFeed.h"
+#include "DspStages.h"
+#include "Lfo.h"
+#include "ParameterSnapshot.h"
+#include "RealtimeHandover.h"
+#include "ScratchArena.h"
+#include "StageProfiler.h"
 
-class KinaVSTProcessor : public juce::AudioProcessor
+class KinaVSTProcessor : public juce::AudioProcessor,
+                         private juce::Timer
 {
 public:
     KinaVSTProcessor();
@@ -44,6 +23,7 @@ public:
     void releaseResources() override;
     void reset() override;
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
     
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -51,7 +31,7 @@ public:
     const juce::String getName() const override { return JucePlugin_Name; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
     
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -82,61 +62,205 @@ public:
     static const juce::String TRASHER1_MODE_ID;
     static const juce::String TRASHER1_AMOUNT_ID;
     static const juce::String TRASHER1_TONE_ID;
+    static const juce::String TRASHER1_ADAA_ID;
     
     static const juce::String TRASHER2_MODE_ID;
     static const juce::String TRASHER2_AMOUNT_ID;
     static const juce::String TRASHER2_TONE_ID;
+    static const juce::String TRASHER2_ADAA_ID;
     
     static const juce::String ECHO_TIME_ID;
     static const juce::String ECHO_FEEDBACK_ID;
     static const juce::String ECHO_AMOUNT_ID;
     static const juce::String ECHO_SYNC_ID;
+    static const juce::String ECHO_INTERPOLATION_ID;
     
     static const juce::String REVERB_SIZE_ID;
     static const juce::String REVERB_DAMPING_ID;
     static const juce::String REVERB_WIDTH_ID;
     static const juce::String REVERB_AMOUNT_ID;
+    static const juce::String REVERB_ENGINE_ID;
+    static const juce::String REVERB_RATE_ID;
     
     static const juce::String DRY_WET_ID;
     static const juce::String OVERSAMPLING_ID;
+    static const juce::String PARALLEL_OFFLINE_ID;
 
     void randomizeParameters();
+
+    // Per-stage timings of recent blocks; only filled in when KINA_ENABLE_PROFILING is set
+    StageProfiler& getStageProfiler() noexcept { return profiler; }
+
+    // Levels and scope data for the editor, fed only while it switches the feed on
+    AnalysisFeed& getAnalysisFeed() noexcept { return analysisFeed; }
     
 private:
-    std::unique_ptr<juce::dsp::Oscillator<float>> vcaLfo;
-    std::unique_ptr<juce::dsp::Oscillator<float>> vcfLfo;
-    juce::dsp::Gain<float> vca;
-    
-    juce::dsp::StateVariableTPTFilter<float> vcf;
-    
-    juce::dsp::WaveShaper<float> trasher1;
-    juce::dsp::WaveShaper<float> trasher2;
-    
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> echo { 192000 };
-    juce::Reverb reverb;
-    juce::Reverb::Parameters reverbParameters;
-    
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+    // Orders of the Oversampling choice: Off, 2x, 4x, 8x
+    static constexpr int numOversamplingOrders = 4;
+    static constexpr size_t maxOversamplingFactor = 1 << (numOversamplingOrders - 1);
+
+    // Top of the Echo Time range, which the delay line is built for. Synced times are clamped to it.
+    static constexpr double maxEchoSeconds = 2.0;
+
+    // Amount and tone for both Trashers, held at the oversampled rate
+    static constexpr int numOversampledControls = 4;
+
+    // One oversampler per factor for the Trasher section, all built in prepareToPlay so
+    // switching never allocates. processors[0] stays null: order 0 is "Off".
+    struct OversamplingBank
+    {
+        std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, numOversamplingOrders> processors;
+        std::array<int, numOversamplingOrders> latencies {};
+    };
+
+    // The stretch of the chain where channels never mix: VCF, both Trashers with their
+    // oversamplers, the dry path's delay and Echo. The processor runs one for the whole
+    // bus; offline renders can also run one per channel, in parallel.
+    struct ChannelSection
+    {
+        void prepare(const juce::dsp::ProcessSpec& spec);
+        void reset();
+        void setParameters(const ParameterSnapshot& snapshot);
+
+        // Starts the oversampler for a new order from scratch, and lines the dry path up with it
+        void setOversamplingOrder(int order);
+
+        VcfStage vcf;
+        TrasherStage trasher1;
+        TrasherStage trasher2;
+        LatencyCompensationStage dryDelay;
+        EchoStage echo;
+        OversamplingBank oversampling;
+
+        // Trasher amount and tone for one sub-block at the highest oversampled rate
+        std::vector<float> oversampledControls;
+
+        // Time spent in each stage, by whichever thread ran the section, until the profiler collects it
+        StageProfiler::StageTimes stageTimes;
+    };
+
+    // Runs one channel's section over a whole chunk on the worker pool
+    class ChannelJob : public juce::ThreadPoolJob
+    {
+    public:
+        ChannelJob(KinaVSTProcessor& ownerToUse, size_t channelToUse)
+            : juce::ThreadPoolJob("Kina channel " + juce::String(channelToUse)), owner(ownerToUse), channel(channelToUse) {}
+
+        JobStatus runJob() override
+        {
+            // Same float modes as the audio thread, or denormals would break bit-identity
+            juce::ScopedNoDenormals noDenormals;
+            owner.processChannelInParallel(channel);
+            return jobHasFinished;
+        }
+
+    private:
+        KinaVSTProcessor& owner;
+        size_t channel;
+    };
+
+    // What the channel jobs share for the chunk being rendered in parallel
+    struct ParallelChunk
+    {
+        juce::dsp::AudioBlock<float> block, dry;
+        const ModulationBlock* modulation = nullptr;
+        const ParameterSnapshot* snapshot = nullptr;
+        int oversamplingOrder = 0;
+    };
+
+    // Scratch memory for the sub-block pipeline. maxBlockSize is the largest host block it was built for.
+    // With wholeBlocks set there is also room for a whole chunk's dry copy and control signals,
+    // which the parallel offline path renders before any channel starts.
+    struct ScratchSpace
+    {
+        ScratchSpace(int numChannelsToUse, int maxBlockSizeToUse, bool wholeBlocksToUse);
+
+        int numChannels;
+        int maxBlockSize;
+        bool wholeBlocks;
+        ScratchArena arena;
+        std::vector<ModulationBlock> subBlockModulation;
+    };
+
+    // Objects that are rebuilt on the message thread and swapped in by the audio thread
+    RealtimeHandover<ScratchSpace> scratch;
+
+    // Control-rate modulation sources, one value per frame shared by all channels
+    Lfo vcaLfo;
+    Lfo vcfLfo;
+
+    // Signal chain, in processing order: the VCA, the channel section, then the reverb
+    VcaStage vca;
+    ChannelSection section;
+    ReverbStage reverb;
+
+    // Offline only: one mono section per channel and the threads that run them. Built in
+    // prepareToPlay when the host renders offline, and empty otherwise.
+    std::vector<std::unique_ptr<ChannelSection>> channelSections;
+    std::vector<std::unique_ptr<ChannelJob>> channelJobs;
+    std::unique_ptr<juce::ThreadPool> workers;
+    ParallelChunk parallelChunk;
+
+    // Audio thread only: whether the last chunk went through channelSections
+    bool parallelActive = false;
+
+    StageProfiler profiler;
+    AnalysisFeed analysisFeed;
     
     double currentSampleRate = 44100.0;
-    int currentBlockSize = 512;
-    
+    std::atomic<int> currentBlockSize { 512 };
+
+    // Largest block the host has actually sent; the timer grows the buffers if it beats currentBlockSize
+    std::atomic<int> largestHostBlockSize { 0 };
+
+    // Set once prepareToPlay has built everything the timer may later rebuild
+    std::atomic<bool> isPrepared { false };
+
+    // Hosts may prepare and release on a thread other than the message thread, so those two
+    // hold this while they rebuild, and the timer while it reads what they built. The audio
+    // thread never takes it.
+    juce::CriticalSection preparationLock;
+
+    // Audio thread only: the factor in use, and the fade that hides a change of factor
+    int activeOversamplingOrder = 0;
+    juce::SmoothedValue<float> oversamplingFade { 1.0f };
+
+    // Audio thread only: sleep mode. quietSamples counts how long input and output have both been silent.
+    bool sleeping = false;
+    int quietSamples = 0;
+    int quietSamplesBeforeSleep = 0;
+
+    // Tempo for the tail length of a synced echo, from the last block that had one
+    std::atomic<double> lastHostBpm { 120.0 };
+
     juce::Random random;
-    juce::CriticalSection lock;
 
-    // Add smoothed parameters for echo
-    juce::SmoothedValue<float> smoothedEchoTime;
-    juce::SmoothedValue<float> smoothedEchoFeedback;
-    juce::SmoothedValue<float> smoothedEchoAmount;
+    // Parameter atomics cached in the constructor, and per-sample ramps fed from each block's snapshot
+    ParameterPointers parameterPointers;
+    SmoothedParameters smoothed;
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    void processBlockInternal(juce::dsp::AudioBlock<float>& block, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo);
-    void updateOversamplingSettings();
-    void updateLfoWaveforms();
-    float processDistortion(float sample, float amount, float tone, TrasherMode mode);
-    float getLfoValue(juce::dsp::Oscillator<float>& lfo, bool sync, float rate, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo);
-    void initializeOversampling(int samplesPerBlock);
-    void setupWaveShapers();
+    void cacheParameterPointers();
+    void processBlockInternal(juce::dsp::AudioBlock<float>& block, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo,
+                              ScratchSpace& scratchSpace, int oversamplingOrder);
+    void processBlockInParallel(juce::dsp::AudioBlock<float>& block, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo,
+                                ScratchSpace& scratchSpace, const ParameterSnapshot& snapshot, int oversamplingOrder);
+    void processChannelInParallel(size_t channel);
+    void processSection(ChannelSection& channelSection, const juce::dsp::AudioBlock<float>& subBlock, const juce::dsp::AudioBlock<float>& dry,
+                        const ModulationBlock& modulation, const ParameterSnapshot& snapshot, int oversamplingOrder) const;
+    bool canRunInParallel(const ParameterSnapshot& snapshot, size_t numChannels) const;
+    template <typename Fn> void forEachSection(Fn&& fn);
+    void switchOversamplingOrder(int order);
+    void timerCallback() override;
+    void updateLatency();
+    void updateBlockSize();
+    static OversamplingBank createOversamplingBank(int numChannels);
+    int getRequestedOversamplingOrder() const noexcept;
+    void renderModulation(const ModulationBlock& modulation, const ParameterSnapshot& snapshot, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo);
+    void renderLfo(Lfo& lfo, SmoothedParameters::Multiplicative& rate, bool sync, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo, float* output, size_t numSamples);
+    void updateSleepState(bool quiet, size_t numSamples);
+    static float getEchoBeats(float echoTime) noexcept;
+    void advanceLfo(Lfo& lfo, SmoothedParameters::Multiplicative& rate, bool sync, const juce::Optional<juce::AudioPlayHead::PositionInfo>& posInfo, size_t numSamples);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KinaVSTProcessor)
 }; 
\ No newline at end of file
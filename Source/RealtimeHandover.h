@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+/**
+    Hands heap objects that were built on the message thread over to the audio
+    thread without taking a lock.
+
+    The message thread publishes a finished object into the pending slot. At the
+    start of a block the audio thread swaps it in with a single atomic exchange
+    and parks the object it replaces in the retired slot. Retired objects are
+    deleted by the next collectGarbage() call on the message thread, so nothing
+    is ever allocated or freed on the audio thread.
+
+    If the previous retiree hasn't been collected yet, the audio thread simply
+    keeps using its current object for another block.
+*/
+template <typename ObjectType>
+class RealtimeHandover
+{
+public:
+    RealtimeHandover() = default;
+
+    ~RealtimeHandover()
+    {
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+        delete live;
+    }
+
+    /** Message thread: queues a replacement object. Anything that was published
+        earlier but never picked up by the audio thread is freed here.
+    */
+    void publish(std::unique_ptr<ObjectType> newObject)
+    {
+        collectGarbage();
+        delete pending.exchange(newObject.release(), std::memory_order_acq_rel);
+    }
+
+    /** Message thread: frees whatever the audio thread has retired. */
+    void collectGarbage()
+    {
+        delete retired.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    /** Replaces the live object directly. Only call this while the audio thread
+        is guaranteed not to be running, e.g. from prepareToPlay or releaseResources.
+    */
+    void reset(std::unique_ptr<ObjectType> newObject)
+    {
+        delete pending.exchange(nullptr, std::memory_order_acq_rel);
+        collectGarbage();
+        delete live;
+        live = newObject.release();
+    }
+
+    /** Audio thread: installs a pending object if there is one and returns the
+        object to use for this block. Wait-free.
+    */
+    ObjectType* acquire() noexcept
+    {
+        if (pending.load(std::memory_order_relaxed) != nullptr
+             && retired.load(std::memory_order_acquire) == nullptr)
+        {
+            if (auto* incoming = pending.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                retired.store(live, std::memory_order_release);
+                live = incoming;
+            }
+        }
+
+        return live;
+    }
+
+    /** Audio thread: the object installed by the last acquire(). */
+    ObjectType* get() const noexcept { return live; }
+
+private:
+    std::atomic<ObjectType*> pending { nullptr };
+    std::atomic<ObjectType*> retired { nullptr };
+    ObjectType* live = nullptr;
+
+    RealtimeHandover(const RealtimeHandover&) = delete;
+    RealtimeHandover& operator=(const RealtimeHandover&) = delete;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+    One aligned allocation that the audio thread carves scratch buffers from.
+
+    The arena is sized up front on the message thread. On the audio thread,
+    allocate() just bumps an offset and reset() rewinds it at the start of
+    each block, so nothing touches the heap while processing. Every buffer
+    starts on a 64 byte boundary, which keeps SIMD loads aligned and stops
+    neighbouring buffers from sharing a cache line.
+*/
+class ScratchArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    ScratchArena() = default;
+
+    explicit ScratchArena(size_t capacityInBytes)
+    {
+        storage.allocate(capacityInBytes + alignment, true);
+        const auto address = reinterpret_cast<uintptr_t>(storage.get());
+        base = storage.get() + (alignUp(address) - address);
+        capacity = capacityInBytes;
+    }
+
+    /** Bytes needed for an allocateBlock() call of this shape, including padding. */
+    static constexpr size_t bytesForBlock(size_t numChannels, size_t numSamples) noexcept
+    {
+        return alignUp(numChannels * sizeof(float*)) + numChannels * alignUp(numSamples * sizeof(float));
+    }
+
+    /** Bytes needed for an allocateSamples() call, including padding. */
+    static constexpr size_t bytesForSamples(size_t numSamples) noexcept
+    {
+        return alignUp(numSamples * sizeof(float));
+    }
+
+    size_t getCapacity() const noexcept   { return capacity; }
+    size_t getBytesUsed() const noexcept  { return used; }
+
+    /** Audio thread: frees everything handed out since the last reset. */
+    void reset() noexcept  { used = 0; }
+
+    /** Audio thread: an uninitialised run of samples, or nullptr if the arena is full. */
+    float* allocateSamples(size_t numSamples) noexcept
+    {
+        return static_cast<float*>(allocateBytes(numSamples * sizeof(float)));
+    }
+
+    /** Audio thread: an uninitialised multichannel block, or an empty block if the arena is full. */
+    juce::dsp::AudioBlock<float> allocateBlock(size_t numChannels, size_t numSamples) noexcept
+    {
+        if (bytesForBlock(numChannels, numSamples) > capacity - used)
+        {
+            jassertfalse; // the arena was sized for a smaller block than this
+            return {};
+        }
+
+        auto** channels = static_cast<float**>(allocateBytes(numChannels * sizeof(float*)));
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            channels[ch] = allocateSamples(numSamples);
+
+        return juce::dsp::AudioBlock<float>(channels, numChannels, numSamples);
+    }
+
+private:
+    static constexpr size_t alignUp(size_t value) noexcept
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void* allocateBytes(size_t numBytes) noexcept
+    {
+        const auto size = alignUp(numBytes);
+
+        if (size > capacity - used)
+        {
+            jassertfalse; // the arena was sized for a smaller block than this
+            return nullptr;
+        }
+
+        auto* result = base + used;
+        used += size;
+        return result;
+    }
+
+    juce::HeapBlock<char> storage;
+    char* base = nullptr;
+    size_t capacity = 0, used = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(ScratchArena)
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "DspTypes.h"
+
+/**
+    Topology-preserving state variable filter that runs several channels at once,
+    one channel per SIMD lane.
+
+    The structure and the LP/BP/HP outputs are the same as juce::dsp::StateVariableTPTFilter.
+    Coefficients arrive per sample and are shared by every channel, because the
+    whole bus follows the same cutoff modulation. Channels beyond the register
+    width go into further registers, so a bus of up to maxChannels channels costs
+    one pass per register rather than one pass per channel.
+*/
+class SimdStateVariableFilter
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+    static constexpr size_t maxChannels = 8;
+
+    /** Per-sample coefficients: g = tan (pi * fc / fs), k = g + 1 / Q and h = 1 / (1 + g * k). */
+    struct Coefficients
+    {
+        const float* g = nullptr;
+        const float* k = nullptr;
+        const float* h = nullptr;
+    };
+
+    SimdStateVariableFilter()  { reset(); }
+
+    void setType(FilterType newType) noexcept  { type = newType; }
+
+    void reset() noexcept
+    {
+        for (size_t i = 0; i < numGroups; ++i)
+            s1[i] = s2[i] = Vec::expand(0.0f);
+    }
+
+    /** Filters every channel of the block in place. Channels past maxChannels are left alone. */
+    void process(const juce::dsp::AudioBlock<float>& block, const Coefficients& coefficients) noexcept
+    {
+        switch (type)
+        {
+            case FilterType::LowPass:   processGroups<FilterType::LowPass>(block, coefficients); break;
+            case FilterType::BandPass:  processGroups<FilterType::BandPass>(block, coefficients); break;
+            case FilterType::HighPass:  processGroups<FilterType::HighPass>(block, coefficients); break;
+        }
+    }
+
+private:
+    static constexpr size_t numGroups = (maxChannels + numLanes - 1) / numLanes;
+    static constexpr size_t framesPerChunk = 64;
+
+    template <FilterType filterType>
+    void processGroups(const juce::dsp::AudioBlock<float>& block, const Coefficients& c) noexcept
+    {
+        const auto numChannels = juce::jmin(block.getNumChannels(), maxChannels);
+        const auto numSamples = block.getNumSamples();
+
+        // One frame per row, one channel per lane, so every load and store is a single aligned register
+        alignas(64) float frames[framesPerChunk * numLanes];
+
+        for (size_t firstChannel = 0; firstChannel < numChannels; firstChannel += numLanes)
+        {
+            const auto lanesUsed = juce::jmin(numLanes, numChannels - firstChannel);
+            auto v1 = s1[firstChannel / numLanes];
+            auto v2 = s2[firstChannel / numLanes];
+
+            for (size_t start = 0; start < numSamples; start += framesPerChunk)
+            {
+                const auto numFrames = juce::jmin(framesPerChunk, numSamples - start);
+
+                // Unused lanes just filter silence
+                if (lanesUsed < numLanes)
+                    std::fill(frames, frames + numFrames * numLanes, 0.0f);
+
+                for (size_t lane = 0; lane < lanesUsed; ++lane)
+                {
+                    const auto* src = block.getChannelPointer(firstChannel + lane) + start;
+
+                    for (size_t i = 0; i < numFrames; ++i)
+                        frames[i * numLanes + lane] = src[i];
+                }
+
+                const auto* g = c.g + start;
+                const auto* k = c.k + start;
+                const auto* h = c.h + start;
+
+                for (size_t i = 0; i < numFrames; ++i)
+                {
+                    auto* frame = frames + i * numLanes;
+                    const auto x = Vec::fromRawArray(frame);
+                    const auto gi = Vec::expand(g[i]);
+
+                    const auto yHP = Vec::expand(h[i]) * (x - v1 * Vec::expand(k[i]) - v2);
+
+                    const auto yBP = yHP * gi + v1;
+                    v1 = yHP * gi + yBP;
+
+                    const auto yLP = yBP * gi + v2;
+                    v2 = yBP * gi + yLP;
+
+                    if constexpr (filterType == FilterType::LowPass)        yLP.copyToRawArray(frame);
+                    else if constexpr (filterType == FilterType::BandPass)  yBP.copyToRawArray(frame);
+                    else                                                    yHP.copyToRawArray(frame);
+                }
+
+                for (size_t lane = 0; lane < lanesUsed; ++lane)
+                {
+                    auto* dst = block.getChannelPointer(firstChannel + lane) + start;
+
+                    for (size_t i = 0; i < numFrames; ++i)
+                        dst[i] = frames[i * numLanes + lane];
+                }
+            }
+
+            s1[firstChannel / numLanes] = v1;
+            s2[firstChannel / numLanes] = v2;
+        }
+    }
+
+    FilterType type = FilterType::LowPass;
+    Vec s1[numGroups], s2[numGroups];
+};
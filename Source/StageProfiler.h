@@ -0,0 +1,304 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+// Builds with this off compile every probe to nothing; CMake sets it from the option of the same name
+#ifndef KINA_ENABLE_PROFILING
+ #define KINA_ENABLE_PROFILING 0
+#endif
+
+/**
+    Per-stage CPU timings for the audio path.
+
+    The audio thread wraps each stage in measure(), which adds the stage's time
+    to a StageTimes accumulator, and each host block in a BlockScope. When the
+    block ends its totals go into a preallocated single-producer ring (an
+    AbstractFifo), so the audio thread never locks or allocates; if the ring is
+    full the block is dropped and counted. getStatistics() drains the ring on
+    any other thread into a history of recent blocks and summarises it.
+
+    Stage times are CPU time summed over every thread that ran the stage, so on
+    the parallel offline path they can add up to more than the block's wall time.
+
+    With KINA_ENABLE_PROFILING at 0 the probes compile away, measure() just
+    calls its function, and getStatistics() reports no blocks.
+*/
+class StageProfiler
+{
+public:
+    static constexpr bool isEnabled() noexcept  { return KINA_ENABLE_PROFILING != 0; }
+
+    enum class Stage
+    {
+        Modulation,
+        Dry,
+        Vca,
+        Vcf,
+        OversampleUp,
+        Trasher1,
+        Trasher2,
+        OversampleDown,
+        Echo,
+        Reverb,
+        Mix,
+        count
+    };
+
+    static constexpr size_t numStages = static_cast<size_t>(Stage::count);
+
+    static const char* getStageName(Stage stage) noexcept
+    {
+        static constexpr const char* names[] = { "modulation", "dry", "vca", "vcf", "oversample_up", "trasher1",
+                                                 "trasher2", "oversample_down", "echo", "reverb", "mix" };
+        static_assert(std::size(names) == numStages, "One name per stage");
+        return names[static_cast<size_t>(stage)];
+    }
+
+    /** Ticks spent in each stage so far; one per thread that runs stages. */
+    struct StageTimes
+    {
+        std::array<juce::int64, numStages> ticks {};
+
+        void clear() noexcept  { ticks.fill(0); }
+    };
+
+    /** Adds the time until it goes out of scope to one stage. */
+    class Scope
+    {
+    public:
+        Scope(StageTimes& timesToUse, Stage stageToUse) noexcept
+            : times(timesToUse), stage(stageToUse), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~Scope() noexcept
+        {
+            times.ticks[static_cast<size_t>(stage)] += juce::Time::getHighResolutionTicks() - start;
+        }
+
+    private:
+        StageTimes& times;
+        Stage stage;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    /** Calls fn and returns its result, timing it as one stage when profiling is compiled in. */
+    template <typename Fn>
+    static decltype(auto) measure(StageTimes& times, Stage stage, Fn&& fn)
+    {
+        if constexpr (isEnabled())
+        {
+            const Scope scope(times, stage);
+            return fn();
+        }
+        else
+        {
+            juce::ignoreUnused(times, stage);
+            return fn();
+        }
+    }
+
+    /** Times one host block from construction to destruction and publishes it. */
+    class BlockScope
+    {
+    public:
+        BlockScope(StageProfiler& ownerToUse, int numSamplesToUse, double sampleRateToUse) noexcept
+            : owner(ownerToUse), numSamples(numSamplesToUse), sampleRate(sampleRateToUse)
+        {
+            if constexpr (isEnabled())
+                start = juce::Time::getHighResolutionTicks();
+        }
+
+        ~BlockScope() noexcept
+        {
+            if constexpr (isEnabled())
+                owner.publish(juce::Time::getHighResolutionTicks() - start, numSamples, sampleRate);
+        }
+
+    private:
+        StageProfiler& owner;
+        int numSamples;
+        double sampleRate;
+        juce::int64 start = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(BlockScope)
+    };
+
+    struct Summary
+    {
+        double average = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    struct Statistics
+    {
+        int numBlocks = 0;                                  // blocks the figures cover
+        juce::int64 droppedBlocks = 0;                      // blocks lost to a full ring since the last reset
+        std::array<Summary, numStages> stageNanoseconds {}; // per block
+        Summary blockNanoseconds;
+        Summary deadlineFraction;                           // block time over the block's duration
+    };
+
+    StageProfiler()
+    {
+        if constexpr (isEnabled())
+        {
+            ring.resize(static_cast<size_t>(ringSize));
+            history.resize(historySize);
+        }
+    }
+
+    /** Audio thread only: the accumulator for stages that run on the audio thread itself. */
+    StageTimes& getBlockTimes() noexcept  { return blockTimes; }
+
+    /** Audio thread only: adds another thread's stage times to this block's and clears them.
+        Call once that thread has finished with them for the block.
+    */
+    void collect(StageTimes& times) noexcept
+    {
+        if constexpr (isEnabled())
+        {
+            for (size_t i = 0; i < numStages; ++i)
+                blockTimes.ticks[i] += times.ticks[i];
+
+            times.clear();
+        }
+        else
+        {
+            juce::ignoreUnused(times);
+        }
+    }
+
+    /** Drains what the audio thread has published and summarises the recent blocks. */
+    Statistics getStatistics()
+    {
+        Statistics statistics;
+
+        if constexpr (isEnabled())
+        {
+            const juce::ScopedLock lock(readerLock);
+            drain();
+
+            statistics.numBlocks = static_cast<int>(historyCount);
+            statistics.droppedBlocks = droppedBlocks.load(std::memory_order_relaxed);
+
+            if (historyCount == 0)
+                return statistics;
+
+            std::vector<double> values(historyCount);
+
+            const auto summarise = [&](auto&& getValue)
+            {
+                for (size_t i = 0; i < historyCount; ++i)
+                    values[i] = getValue(history[i]);
+
+                Summary summary;
+                double sum = 0.0;
+
+                for (auto value : values)
+                {
+                    sum += value;
+                    summary.max = juce::jmax(summary.max, value);
+                }
+
+                summary.average = sum / static_cast<double>(historyCount);
+
+                const auto rank = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(historyCount))) - 1;
+                std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+                summary.p99 = values[rank];
+
+                return summary;
+            };
+
+            for (size_t s = 0; s < numStages; ++s)
+                statistics.stageNanoseconds[s] = summarise([s](const Record& r) { return r.stageNanoseconds[s]; });
+
+            statistics.blockNanoseconds = summarise([](const Record& r) { return r.blockNanoseconds; });
+            statistics.deadlineFraction = summarise([](const Record& r) { return r.blockNanoseconds / r.deadlineNanoseconds; });
+        }
+
+        return statistics;
+    }
+
+    /** Forgets every block published so far. */
+    void clearHistory()
+    {
+        if constexpr (isEnabled())
+        {
+            const juce::ScopedLock lock(readerLock);
+            drain();
+            historyCount = 0;
+            historyNext = 0;
+            droppedBlocks.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    // Room for about a second of 64 sample blocks at 48 kHz, before a reader has to drain it
+    static constexpr int ringSize = 1024;
+
+    // Blocks the statistics cover
+    static constexpr size_t historySize = 4096;
+
+    struct Record
+    {
+        std::array<double, numStages> stageNanoseconds {};
+        double blockNanoseconds = 0.0;
+        double deadlineNanoseconds = 1.0;
+    };
+
+    void publish(juce::int64 blockTicks, int numSamples, double sampleRate) noexcept
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+        {
+            droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+            blockTimes.clear();
+            return;
+        }
+
+        auto& record = ring[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+
+        for (size_t i = 0; i < numStages; ++i)
+            record.stageNanoseconds[i] = static_cast<double>(blockTimes.ticks[i]) * nanosecondsPerTick;
+
+        record.blockNanoseconds = static_cast<double>(blockTicks) * nanosecondsPerTick;
+        record.deadlineNanoseconds = juce::jmax(1.0, 1.0e9 * numSamples / sampleRate);
+        blockTimes.clear();
+    }
+
+    // Reader only, with readerLock held
+    void drain()
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+
+        scope.forEach([this](int index)
+        {
+            history[historyNext] = ring[static_cast<size_t>(index)];
+            historyNext = (historyNext + 1) % historySize;
+            historyCount = juce::jmin(historyCount + 1, historySize);
+        });
+    }
+
+    const double nanosecondsPerTick = 1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+    // Audio thread only
+    StageTimes blockTimes;
+
+    juce::AbstractFifo fifo { ringSize };
+    std::vector<Record> ring;
+    std::atomic<juce::int64> droppedBlocks { 0 };
+
+    juce::CriticalSection readerLock;
+    std::vector<Record> history;
+    size_t historyCount = 0, historyNext = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(StageProfiler)
+};
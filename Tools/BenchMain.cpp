@@ -0,0 +1,583 @@
+/*
+    kina_bench: microbenchmarks for every DSP stage and for the whole processBlock.
+
+    kina_bench [options]
+
+      --stage <name>          only run benchmarks whose name contains this (default: all)
+      --block <samples>       only this host block size (default: 16 to 4096 in powers of two)
+      --rate <Hz>             only this sample rate (default: 44.1 to 192 kHz)
+      --oversampling <1|2|4|8>
+      --channels <1-8>        bus width, e.g. 6 for 5.1 or 8 for 7.1 (default 2)
+      --seconds <s>           audio time measured per data point (default 0.25)
+      --format <csv|json>     csv (default) or one JSON object per line
+      --check-math            check FastMath against libm instead, and fail if it's out of bounds
+      --check-parallel        check that parallel offline renders match single-threaded ones bit for bit
+      --profile               render noise through processBlock at one --block, --rate, --oversampling and
+                              --channels (default 512, 48000, 1, 2) for --seconds (default 5) and print
+                              the per-stage timings; needs a build with KINA_ENABLE_PROFILING
+
+    Every data point reports ns and cycles per host sample, plus the realtime factor.
+    Cycles come from the CPU's timestamp counter where there is one (x86) and are
+    -1 elsewhere. Stages run at the rate and in the sub-block size the plugin would
+    use: only the Trashers are oversampled, so only they (and the whole processBlock)
+    are swept over the oversampling factors.
+*/
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+#include "DspStages.h"
+#include "FastMath.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    constexpr int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    constexpr double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    constexpr int oversamplingFactors[] = { 1, 2, 4, 8 };
+
+    //==============================================================================
+    juce::int64 readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL
+        return static_cast<juce::int64>(__rdtsc());
+       #else
+        return -1;
+       #endif
+    }
+
+    struct Configuration
+    {
+        int blockSize;
+        double sampleRate;
+        int oversampling;
+        int numChannels = 2;
+    };
+
+    struct Measurement
+    {
+        double nsPerSample = 0.0;
+        double cyclesPerSample = -1.0;
+        double realtimeFactor = 0.0;
+    };
+
+    /** Runs processOneBlock until `seconds` of host audio has gone through it. */
+    Measurement measure(const Configuration& config, double seconds, const std::function<void()>& processOneBlock)
+    {
+        // Warm up caches, branch predictors and smoothers
+        for (int i = 0; i < 8; ++i)
+            processOneBlock();
+
+        const auto numBlocks = juce::jmax(16, static_cast<int>(seconds * config.sampleRate / config.blockSize));
+
+        const auto startCycles = readCycleCounter();
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numBlocks; ++i)
+            processOneBlock();
+
+        const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        const auto elapsedCycles = readCycleCounter() - startCycles;
+        const auto numSamples = static_cast<double>(numBlocks) * config.blockSize;
+
+        Measurement m;
+        m.nsPerSample = elapsedSeconds * 1.0e9 / numSamples;
+        m.cyclesPerSample = startCycles >= 0 ? static_cast<double>(elapsedCycles) / numSamples : -1.0;
+        m.realtimeFactor = (numSamples / config.sampleRate) / juce::jmax(elapsedSeconds, 1.0e-12);
+        return m;
+    }
+
+    //==============================================================================
+    /** Owns a processing-rate test signal and a set of constant control signals. */
+    struct StageHarness
+    {
+        StageHarness(const Configuration& config, bool oversampled = false)
+            : factor(oversampled ? static_cast<size_t>(config.oversampling) : 1),
+              processingRate(config.sampleRate * static_cast<double>(factor)),
+              numSamples(static_cast<size_t>(config.blockSize) * factor),
+              subBlockSize(maxSubBlockSize * factor),
+              source(config.numChannels, static_cast<int>(numSamples)),
+              work(config.numChannels, static_cast<int>(numSamples))
+        {
+            juce::Random random(1234);
+            for (int ch = 0; ch < source.getNumChannels(); ++ch)
+                for (int i = 0; i < source.getNumSamples(); ++i)
+                    source.setSample(ch, i, random.nextFloat() * 1.6f - 0.8f);
+
+            for (auto& buffer : controls)
+                buffer.resize(subBlockSize);
+
+            modulation.numSamples = subBlockSize;
+            modulation.vcaGain = fill(0, 0.8f);
+            modulation.vcfCutoffOctaves = fill(1, std::log2(1000.0f));
+            modulation.vcfResonance = fill(2, 0.707f);
+            modulation.trasher1Amount = fill(3, 0.7f);
+            modulation.trasher1Tone = fill(4, 0.3f);
+            modulation.trasher2Amount = fill(5, 0.7f);
+            modulation.trasher2Tone = fill(6, 0.3f);
+            modulation.echoDelay = fill(7, static_cast<float>(0.3 * processingRate));
+            modulation.echoFeedback = fill(8, 0.5f);
+            modulation.echoAmount = fill(9, 0.3f);
+            modulation.dryWet = fill(10, 1.0f);
+        }
+
+        juce::dsp::ProcessSpec getSpec() const
+        {
+            return { processingRate, static_cast<juce::uint32>(subBlockSize), static_cast<juce::uint32>(source.getNumChannels()) };
+        }
+
+        /** Sweeps the cutoff across the sub-block, like the VCF LFO does at audio rate. */
+        void modulateCutoff()
+        {
+            for (size_t i = 0; i < maxSubBlockSize; ++i)
+                modulation.vcfCutoffOctaves[i] = std::log2(1000.0f) + 2.0f * std::sin(0.1f * static_cast<float>(i));
+        }
+
+        /** Refreshes the input, then runs the stage over it in sub-blocks. */
+        void run(const std::function<void(const juce::dsp::AudioBlock<float>&)>& stage)
+        {
+            for (int ch = 0; ch < work.getNumChannels(); ++ch)
+                work.copyFrom(ch, 0, source, ch, 0, static_cast<int>(numSamples));
+
+            juce::dsp::AudioBlock<float> block(work);
+
+            for (size_t start = 0; start < numSamples; start += subBlockSize)
+                stage(block.getSubBlock(start, juce::jmin(subBlockSize, numSamples - start)));
+        }
+
+        size_t factor;
+        double processingRate;
+        size_t numSamples;
+        size_t subBlockSize;
+        juce::AudioBuffer<float> source, work;
+        std::array<std::vector<float>, ModulationBlock::numBuffers> controls;
+        ModulationBlock modulation;
+
+    private:
+        float* fill(size_t index, float value)
+        {
+            std::fill(controls[index].begin(), controls[index].end(), value);
+            return controls[index].data();
+        }
+    };
+
+    //==============================================================================
+    struct Benchmark
+    {
+        const char* name;
+        std::function<Measurement(const Configuration&, double seconds)> run;
+        bool oversampled = false; // whether the oversampling factor changes what it measures
+    };
+
+    /** Everything on, so every stage does real work, and prepared for an offline render. */
+    void prepareProcessor(KinaVSTProcessor& processor, const Configuration& config, bool parallel)
+    {
+        const std::pair<const juce::String*, float> settings[] = {
+            { &KinaVSTProcessor::VCF_LFO_AMOUNT_ID, 0.5f },
+            { &KinaVSTProcessor::TRASHER1_AMOUNT_ID, 0.5f },
+            { &KinaVSTProcessor::TRASHER2_AMOUNT_ID, 0.5f },
+            { &KinaVSTProcessor::OVERSAMPLING_ID, static_cast<float>(juce::roundToInt(std::log2(config.oversampling))) },
+            { &KinaVSTProcessor::PARALLEL_OFFLINE_ID, parallel ? 1.0f : 0.0f }
+        };
+
+        for (const auto& [id, value] : settings)
+            if (auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(processor.parameters.getParameter(*id)))
+                parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+
+        // Surround widths get their usual layout, so the LFE is where a host would put it
+        juce::AudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(config.numChannels));
+        buses.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(config.numChannels));
+        processor.setBusesLayout(buses);
+
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(config.numChannels, config.numChannels, config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+    }
+
+    Measurement benchmarkProcessBlock(const Configuration& config, double seconds, bool parallel)
+    {
+        KinaVSTProcessor processor;
+        prepareProcessor(processor, config, parallel);
+
+        juce::AudioBuffer<float> source(config.numChannels, config.blockSize), buffer(config.numChannels, config.blockSize);
+        juce::Random random(1234);
+        for (int ch = 0; ch < config.numChannels; ++ch)
+            for (int i = 0; i < config.blockSize; ++i)
+                source.setSample(ch, i, random.nextFloat() * 1.6f - 0.8f);
+
+        juce::MidiBuffer midi;
+
+        return measure(config, seconds, [&]
+        {
+            buffer.makeCopyOf(source, true);
+            processor.processBlock(buffer, midi);
+        });
+    }
+
+    std::vector<Benchmark> createBenchmarks()
+    {
+        std::vector<Benchmark> benchmarks;
+
+        benchmarks.push_back({ "vca", [](const Configuration& config, double seconds)
+        {
+            StageHarness harness(config);
+            VcaStage vca;
+            return measure(config, seconds, [&] { harness.run([&](const auto& block) { vca.process(block, harness.modulation.vcaGain); }); });
+        }});
+
+        for (const bool modulated : { false, true })
+        {
+            benchmarks.push_back({ modulated ? "vcf_lfo" : "vcf_static", [modulated](const Configuration& config, double seconds)
+            {
+                StageHarness harness(config);
+                if (modulated)
+                    harness.modulateCutoff();
+
+                VcfStage vcf;
+                vcf.prepare(harness.getSpec());
+                vcf.setType(FilterType::LowPass);
+
+                return measure(config, seconds, [&]
+                {
+                    if (modulated)
+                        harness.run([&](const auto& block) { vcf.process(block, harness.modulation.vcfCutoffOctaves, harness.modulation.vcfResonance); });
+                    else
+                        harness.run([&](const auto& block) { vcf.process(block, harness.modulation.vcfCutoffOctaves[0], harness.modulation.vcfResonance[0]); });
+                });
+            }});
+        }
+
+        const std::tuple<const char*, TrasherMode, bool> trashers[] = {
+            { "trasher_fuzz", TrasherMode::Fuzz, false },
+            { "trasher_scream", TrasherMode::Scream, false },
+            { "trasher_fuzz_adaa", TrasherMode::Fuzz, true },
+            { "trasher_scream_adaa", TrasherMode::Scream, true }
+        };
+
+        for (const auto& [name, mode, antialiased] : trashers)
+        {
+            benchmarks.push_back({ name, [mode = mode, antialiased = antialiased](const Configuration& config, double seconds)
+            {
+                StageHarness harness(config, true);
+                TrasherStage trasher;
+                trasher.prepare(harness.getSpec());
+
+                return measure(config, seconds, [&]
+                {
+                    harness.run([&](const auto& block) { trasher.process(block, harness.modulation.trasher1Amount, harness.modulation.trasher1Tone, mode, antialiased); });
+                });
+            }, true });
+        }
+
+        const std::pair<const char*, EchoInterpolation> echoes[] = {
+            { "echo_linear", EchoInterpolation::Linear },
+            { "echo_lagrange", EchoInterpolation::Lagrange3 },
+            { "echo_thiran", EchoInterpolation::Thiran }
+        };
+
+        for (const auto& [name, interpolation] : echoes)
+        {
+            benchmarks.push_back({ name, [interpolation = interpolation](const Configuration& config, double seconds)
+            {
+                StageHarness harness(config);
+                EchoStage echo;
+                echo.prepare(harness.getSpec(), 2.0);
+                echo.setInterpolation(interpolation);
+
+                return measure(config, seconds, [&]
+                {
+                    harness.run([&](const auto& block) { echo.process(block, harness.modulation.echoDelay, harness.modulation.echoFeedback, harness.modulation.echoAmount); });
+                });
+            }});
+        }
+
+        const std::tuple<const char*, ReverbEngine, ReverbRate> reverbs[] = {
+            { "reverb_classic", ReverbEngine::Classic, ReverbRate::Full },
+            { "reverb_classic_half", ReverbEngine::Classic, ReverbRate::Half },
+            { "reverb_classic_quarter", ReverbEngine::Classic, ReverbRate::Quarter },
+            { "reverb_fdn", ReverbEngine::Fdn, ReverbRate::Full },
+            { "reverb_fdn_half", ReverbEngine::Fdn, ReverbRate::Half },
+            { "reverb_fdn_quarter", ReverbEngine::Fdn, ReverbRate::Quarter }
+        };
+
+        for (const auto& [name, engine, rate] : reverbs)
+        {
+            benchmarks.push_back({ name, [engine = engine, rate = rate](const Configuration& config, double seconds)
+            {
+                StageHarness harness(config);
+                ReverbStage reverb;
+                reverb.prepare(harness.processingRate);
+                reverb.setLfeChannel(juce::AudioChannelSet::canonicalChannelSet(config.numChannels)
+                                         .getChannelIndexForType(juce::AudioChannelSet::LFE));
+                reverb.setEngine(engine, rate);
+                reverb.reset();
+                reverb.setParameters(0.5f, 0.5f, 1.0f, 0.3f);
+
+                return measure(config, seconds, [&] { harness.run([&](const auto& block) { reverb.process(block); }); });
+            }});
+        }
+
+        benchmarks.push_back({ "process_block", [](const Configuration& config, double seconds)
+        {
+            return benchmarkProcessBlock(config, seconds, false);
+        }, true });
+
+        benchmarks.push_back({ "process_block_parallel", [](const Configuration& config, double seconds)
+        {
+            return benchmarkProcessBlock(config, seconds, true);
+        }, true });
+
+        return benchmarks;
+    }
+
+    //==============================================================================
+    void printResult(bool json, const char* name, const Configuration& config, const Measurement& m)
+    {
+        if (json)
+        {
+            std::cout << "{\"stage\":\"" << name << "\",\"block_size\":" << config.blockSize
+                      << ",\"sample_rate\":" << config.sampleRate << ",\"oversampling\":" << config.oversampling
+                      << ",\"channels\":" << config.numChannels
+                      << ",\"ns_per_sample\":" << m.nsPerSample << ",\"cycles_per_sample\":" << m.cyclesPerSample
+                      << ",\"realtime_factor\":" << m.realtimeFactor << "}\n";
+        }
+        else
+        {
+            std::cout << name << "," << config.blockSize << "," << config.sampleRate << "," << config.oversampling << ","
+                      << config.numChannels << ","
+                      << m.nsPerSample << "," << m.cyclesPerSample << "," << m.realtimeFactor << "\n";
+        }
+
+        std::cout.flush();
+    }
+
+    //==============================================================================
+    // Sweeps the block versions of FastMath, so the SIMD path is the one checked. tanh covers
+    // well past the largest drive (41x a resonant peak); exp2 covers its whole clamped range.
+    bool checkFastMath()
+    {
+        constexpr int numPoints = 1 << 22;
+        std::vector<float> input(numPoints), output(numPoints);
+
+        const auto sweep = [&](float lo, float hi)
+        {
+            for (int i = 0; i < numPoints; ++i)
+                input[static_cast<size_t>(i)] = juce::jmap(static_cast<float>(i), 0.0f, static_cast<float>(numPoints - 1), lo, hi);
+        };
+
+        sweep(-400.0f, 400.0f);
+        FastMath::tanh(input.data(), output.data(), input.size());
+
+        double tanhError = 0.0;
+        for (size_t i = 0; i < input.size(); ++i)
+            tanhError = juce::jmax(tanhError, std::abs(static_cast<double>(output[i]) - std::tanh(static_cast<double>(input[i]))));
+
+        sweep(-126.0f, 126.0f);
+        FastMath::exp2(input.data(), output.data(), input.size());
+
+        double exp2Error = 0.0;
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            const auto expected = std::exp2(static_cast<double>(input[i]));
+            exp2Error = juce::jmax(exp2Error, std::abs(static_cast<double>(output[i]) - expected) / expected);
+        }
+
+        const bool passed = tanhError <= FastMath::tanhMaxAbsoluteError && exp2Error <= FastMath::exp2MaxRelativeError;
+
+        std::cout << "tanh max absolute error: " << tanhError << " (bound " << FastMath::tanhMaxAbsoluteError << ")\n"
+                  << "exp2 max relative error: " << exp2Error << " (bound " << FastMath::exp2MaxRelativeError << ")\n"
+                  << (passed ? "ok" : "FAILED") << "\n";
+
+        return passed;
+    }
+
+    //==============================================================================
+    // Renders the same noise bursts through a single-threaded and a parallel processor, in
+    // blocks of varying size, at every oversampling factor, in stereo and in 7.1
+    bool checkParallel()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int maxBlockSize = 1024;
+        constexpr int numSamples = static_cast<int>(sampleRate * 4);
+        bool passed = true;
+
+        for (const auto numChannels : { 2, 8 })
+        for (const auto oversampling : oversamplingFactors)
+        {
+            const Configuration config { maxBlockSize, sampleRate, oversampling, numChannels };
+            KinaVSTProcessor single, parallel;
+            prepareProcessor(single, config, false);
+            prepareProcessor(parallel, config, true);
+
+            juce::AudioBuffer<float> a(numChannels, maxBlockSize), b(numChannels, maxBlockSize);
+            juce::MidiBuffer midi;
+            juce::Random random(1234);
+            size_t mismatches = 0;
+
+            for (int start = 0; start < numSamples;)
+            {
+                const auto blockSize = juce::jmin(1 + random.nextInt(maxBlockSize), numSamples - start);
+                a.setSize(numChannels, blockSize, false, false, true);
+                b.setSize(numChannels, blockSize, false, false, true);
+
+                // Bursts with gaps, so the echo and reverb tails and the sleep logic get exercised too
+                const bool burst = (start / 24000) % 2 == 0;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        a.setSample(ch, i, burst ? random.nextFloat() * 1.6f - 0.8f : 0.0f);
+
+                b.makeCopyOf(a, true);
+                single.processBlock(a, midi);
+                parallel.processBlock(b, midi);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    if (std::memcmp(a.getReadPointer(ch), b.getReadPointer(ch), sizeof(float) * static_cast<size_t>(blockSize)) != 0)
+                        ++mismatches;
+
+                start += blockSize;
+            }
+
+            std::cout << numChannels << " channels, " << oversampling << "x: " << (mismatches == 0 ? "identical" : juce::String(mismatches) + " channel blocks differ") << "\n";
+            passed = passed && mismatches == 0;
+        }
+
+        std::cout << (passed ? "ok" : "FAILED") << "\n";
+        return passed;
+    }
+
+    //==============================================================================
+    // The processor's own per-stage timings for one configuration, in ns per host block
+    bool profileProcessBlock(const Configuration& config, double seconds)
+    {
+        if (!StageProfiler::isEnabled())
+        {
+            std::cout << "this build has no profiling probes; configure with -DKINA_ENABLE_PROFILING=ON\n";
+            return false;
+        }
+
+        KinaVSTProcessor processor;
+        prepareProcessor(processor, config, false);
+
+        juce::AudioBuffer<float> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1234);
+        auto& profiler = processor.getStageProfiler();
+        const auto numBlocks = juce::jmax(1, static_cast<int>(seconds * config.sampleRate / config.blockSize));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < config.numChannels; ++ch)
+                for (int i = 0; i < config.blockSize; ++i)
+                    buffer.setSample(ch, i, random.nextFloat() * 1.6f - 0.8f);
+
+            processor.processBlock(buffer, midi);
+
+            // Keeps the profiler's ring from filling up
+            if (b % 256 == 255)
+                profiler.getStatistics();
+        }
+
+        const auto statistics = profiler.getStatistics();
+        const auto printRow = [](const char* name, const StageProfiler::Summary& summary)
+        {
+            std::cout << name << "," << summary.average << "," << summary.p99 << "," << summary.max << "\n";
+        };
+
+        std::cout << "stage,average_ns,p99_ns,max_ns\n";
+
+        for (size_t s = 0; s < StageProfiler::numStages; ++s)
+            printRow(StageProfiler::getStageName(static_cast<StageProfiler::Stage>(s)), statistics.stageNanoseconds[s]);
+
+        printRow("block", statistics.blockNanoseconds);
+
+        std::cout << "deadline_fraction," << statistics.deadlineFraction.average << "," << statistics.deadlineFraction.p99
+                  << "," << statistics.deadlineFraction.max << "\n"
+                  << statistics.numBlocks << " blocks, " << statistics.droppedBlocks << " dropped\n";
+
+        return true;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor benchmark needs a message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "usage: kina_bench [--stage <name>] [--block <samples>] [--rate <Hz>] [--oversampling <1|2|4|8>]\n"
+                     "                  [--channels <1-8>] [--seconds <s>] [--format <csv|json>]\n"
+                     "       kina_bench --check-math\n"
+                     "       kina_bench --check-parallel\n"
+                     "       kina_bench --profile [--block <samples>] [--rate <Hz>] [--oversampling <1|2|4|8>]\n"
+                     "                  [--channels <1-8>] [--seconds <s>]\n";
+        return 0;
+    }
+
+    if (args.containsOption("--check-math"))
+        return checkFastMath() ? 0 : 1;
+
+    if (args.containsOption("--check-parallel"))
+        return checkParallel() ? 0 : 1;
+
+    const auto stageFilter = args.getValueForOption("--stage");
+    const auto blockFilter = args.getValueForOption("--block").getIntValue();
+    const auto rateFilter = args.getValueForOption("--rate").getDoubleValue();
+    const auto oversamplingFilter = args.getValueForOption("--oversampling").getIntValue();
+    const auto numChannels = args.containsOption("--channels")
+                           ? juce::jlimit(1, static_cast<int>(maxBusChannels), args.getValueForOption("--channels").getIntValue())
+                           : 2;
+    const auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 0.25;
+    const bool json = args.getValueForOption("--format") == "json";
+
+    if (args.containsOption("--profile"))
+    {
+        const Configuration config { blockFilter > 0 ? blockFilter : 512, rateFilter > 0.0 ? rateFilter : 48000.0,
+                                     oversamplingFilter > 0 ? oversamplingFilter : 1, numChannels };
+        return profileProcessBlock(config, args.containsOption("--seconds") ? seconds : 5.0) ? 0 : 1;
+    }
+
+    if (!json)
+        std::cout << "stage,block_size,sample_rate,oversampling,channels,ns_per_sample,cycles_per_sample,realtime_factor\n";
+
+    for (const auto& benchmark : createBenchmarks())
+    {
+        if (stageFilter.isNotEmpty() && !juce::String(benchmark.name).contains(stageFilter))
+            continue;
+
+        for (const auto oversampling : oversamplingFactors)
+        for (const auto sampleRate : sampleRates)
+        for (const auto blockSize : blockSizes)
+        {
+            if ((blockFilter > 0 && blockSize != blockFilter)
+                || (rateFilter > 0.0 && !juce::approximatelyEqual(sampleRate, rateFilter))
+                || (oversamplingFilter > 0 && oversampling != oversamplingFilter)
+                || (!benchmark.oversampled && oversampling != 1 && oversamplingFilter == 0))
+                continue;
+
+            const Configuration config { blockSize, sampleRate, oversampling, numChannels };
+            printResult(json, benchmark.name, config, benchmark.run(config, seconds));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,389 @@
+/*
+    kina_render: renders audio files through KinaVSTProcessor without a host.
+
+    kina_render [options] <input files...>
+
+      --output <path>         output file (single input) or directory (default: next to each input)
+      --state <file>          plugin state saved by a host (binary blob or XML)
+      --params <file>         parameter file, one "parameter_id = value" per line, '#' starts a comment
+      --block <samples>       processBlock size (default 512)
+      --oversampling <1|2|4|8>
+      --jobs <n>              worker threads for batch renders (default: number of cores)
+      --tail <seconds>        silence rendered after the input (default: the processor's tail length)
+      --bits <16|24|32>       output bit depth, 32 writes float (default 24)
+
+    Each worker thread owns one processor instance. Output is latency compensated. Files
+    from mono up to 7.1 are processed on a bus of their own width; wider ones as stereo.
+*/
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_events/juce_events.h>
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "PluginProcessor.h"
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::MemoryBlock state;
+        juce::StringPairArray parameterValues;
+        int blockSize = 512;
+        int oversamplingOrder = -1; // -1 keeps whatever the state/parameter file says
+        double tailSeconds = -1.0;  // -1 asks the processor
+        int bitsPerSample = 24;
+    };
+
+    struct RenderResult
+    {
+        bool ok = false;
+        juce::String message;
+        double audioSeconds = 0.0;
+        double wallSeconds = 0.0;
+    };
+
+    constexpr double maxAutomaticTailSeconds = 30.0;
+
+    //==============================================================================
+    bool parseParameterFile(const juce::File& file, juce::StringPairArray& values, juce::String& error)
+    {
+        juce::StringArray lines;
+        file.readLines(lines);
+
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            const auto line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+            if (line.isEmpty())
+                continue;
+
+            if (!line.containsChar('='))
+            {
+                error = file.getFileName() + ":" + juce::String(i + 1) + ": expected \"parameter_id = value\"";
+                return false;
+            }
+
+            values.set(line.upToFirstOccurrenceOf("=", false, false).trim(),
+                       line.fromFirstOccurrenceOf("=", false, false).trim());
+        }
+
+        return true;
+    }
+
+    bool applyParameterValue(KinaVSTProcessor& processor, const juce::String& id, const juce::String& text, juce::String& error)
+    {
+        auto* parameter = processor.parameters.getParameter(id);
+        if (parameter == nullptr)
+        {
+            error = "unknown parameter \"" + id + "\"";
+            return false;
+        }
+
+        // Choices accept either their name ("Scream", "8x") or their index
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(parameter))
+        {
+            auto index = choice->choices.indexOf(text, true);
+            if (index < 0 && text.containsOnly("0123456789"))
+                index = text.getIntValue();
+
+            if (!juce::isPositiveAndBelow(index, choice->choices.size()))
+            {
+                error = "\"" + text + "\" is not a choice of " + id;
+                return false;
+            }
+
+            parameter->setValueNotifyingHost(choice->convertTo0to1(static_cast<float>(index)));
+            return true;
+        }
+
+        parameter->setValueNotifyingHost(parameter->getValueForText(text));
+        return true;
+    }
+
+    bool configureProcessor(KinaVSTProcessor& processor, const RenderSettings& settings, juce::String& error)
+    {
+        if (!settings.state.isEmpty())
+        {
+            // Accept a host's binary blob as well as plain XML
+            if (auto xml = juce::parseXML(settings.state.toString()))
+                processor.parameters.replaceState(juce::ValueTree::fromXml(*xml));
+            else
+                processor.setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+        }
+
+        for (const auto& id : settings.parameterValues.getAllKeys())
+            if (!applyParameterValue(processor, id, settings.parameterValues[id], error))
+                return false;
+
+        if (settings.oversamplingOrder >= 0)
+            return applyParameterValue(processor, KinaVSTProcessor::OVERSAMPLING_ID,
+                                       juce::String(settings.oversamplingOrder), error);
+
+        return true;
+    }
+
+    bool setMainBus(KinaVSTProcessor& processor, const juce::AudioChannelSet& layout)
+    {
+        juce::AudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(layout);
+        buses.outputBuses.add(layout);
+        return processor.setBusesLayout(buses);
+    }
+
+    //==============================================================================
+    RenderResult renderFile(KinaVSTProcessor& processor, juce::AudioFormatManager& formats,
+                            const juce::File& input, const juce::File& output, const RenderSettings& settings)
+    {
+        RenderResult result;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr)
+        {
+            result.message = "can't read " + input.getFullPathName();
+            return result;
+        }
+
+        const auto sampleRate = reader->sampleRate;
+        const auto fileChannels = static_cast<int>(reader->numChannels);
+
+        // Run on a bus as wide as the file where the processor takes one (mono up to 7.1), else stereo
+        auto fileLayout = reader->getChannelLayout();
+        if (fileLayout.size() != fileChannels)
+            fileLayout = juce::AudioChannelSet::canonicalChannelSet(fileChannels);
+
+        if (!setMainBus(processor, fileLayout))
+            setMainBus(processor, juce::AudioChannelSet::stereo());
+
+        const auto processorChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        const auto outputChannels = juce::jmin(fileChannels, processorChannels);
+        const auto blockSize = settings.blockSize;
+
+        output.deleteFile();
+        auto stream = output.createOutputStream();
+        if (stream == nullptr)
+        {
+            result.message = "can't write " + output.getFullPathName();
+            return result;
+        }
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+            static_cast<unsigned int>(outputChannels), settings.bitsPerSample, {}, 0));
+        if (writer == nullptr)
+        {
+            result.message = "can't create a WAV writer for " + output.getFullPathName();
+            return result;
+        }
+        stream.release(); // the writer owns it now
+
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(processorChannels, processorChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        const auto tailSeconds = settings.tailSeconds >= 0.0
+                               ? settings.tailSeconds
+                               : juce::jmin(processor.getTailLengthSeconds(), maxAutomaticTailSeconds);
+        const auto latency = static_cast<juce::int64>(processor.getLatencySamples());
+        const auto inputLength = reader->lengthInSamples;
+        const auto totalLength = inputLength + static_cast<juce::int64>(tailSeconds * sampleRate) + latency;
+
+        juce::AudioBuffer<float> buffer(processorChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        for (juce::int64 position = 0; position < totalLength; position += blockSize)
+        {
+            const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalLength - position));
+            buffer.setSize(processorChannels, numSamples, false, false, true);
+            buffer.clear();
+
+            // Past the end of the file the processor just gets silence for its tail
+            if (position < inputLength)
+            {
+                const auto numToRead = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples), inputLength - position));
+                reader->read(buffer.getArrayOfWritePointers(), juce::jmin(fileChannels, processorChannels), position, numToRead);
+            }
+
+            processor.processBlock(buffer, midi);
+
+            // Drop the first `latency` samples so the output lines up with the input
+            const auto skip = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples), latency - position));
+            if (skip < numSamples)
+                writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+        }
+
+        result.wallSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        result.audioSeconds = static_cast<double>(totalLength - latency) / sampleRate;
+        processor.releaseResources();
+
+        result.ok = true;
+        return result;
+    }
+
+    juce::File getOutputFile(const juce::File& input, const juce::String& outputOption, bool isBatch)
+    {
+        const auto name = input.getFileNameWithoutExtension() + "_kina.wav";
+
+        if (outputOption.isEmpty())
+            return input.getSiblingFile(name);
+
+        const juce::File output(juce::File::getCurrentWorkingDirectory().getChildFile(outputOption));
+        if (isBatch || output.isDirectory())
+            return output.getChildFile(name);
+
+        return output;
+    }
+
+    void printUsage()
+    {
+        std::cout << "usage: kina_render [--output <path>] [--state <file>] [--params <file>] [--block <samples>]\n"
+                     "                   [--oversampling <1|2|4|8>] [--jobs <n>] [--tail <seconds>] [--bits <16|24|32>]\n"
+                     "                   <input files...>\n";
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // Processors need a message manager to exist, even though nothing here runs its loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    RenderSettings settings;
+    juce::String outputOption;
+    int numJobs = static_cast<int>(std::thread::hardware_concurrency());
+    juce::Array<juce::File> inputs;
+
+    try
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const auto takeValue = [&]() -> juce::String
+            {
+                if (arg.text.containsChar('='))
+                    return arg.text.fromFirstOccurrenceOf("=", false, false);
+                if (i + 1 >= args.size())
+                    throw std::runtime_error(("missing value for " + arg.text).toStdString());
+                return args[++i].text;
+            };
+
+            if (arg.isLongOption("output"))             outputOption = takeValue();
+            else if (arg.isLongOption("block"))         settings.blockSize = takeValue().getIntValue();
+            else if (arg.isLongOption("jobs"))          numJobs = takeValue().getIntValue();
+            else if (arg.isLongOption("tail"))          settings.tailSeconds = takeValue().getDoubleValue();
+            else if (arg.isLongOption("bits"))          settings.bitsPerSample = takeValue().getIntValue();
+            else if (arg.isLongOption("oversampling"))
+            {
+                const auto factor = takeValue().getIntValue();
+                if (factor != 1 && factor != 2 && factor != 4 && factor != 8)
+                    throw std::runtime_error("--oversampling must be 1, 2, 4 or 8");
+                settings.oversamplingOrder = juce::roundToInt(std::log2(factor));
+            }
+            else if (arg.isLongOption("state"))
+            {
+                const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(takeValue());
+                if (!file.loadFileAsData(settings.state))
+                    throw std::runtime_error(("can't read " + file.getFullPathName()).toStdString());
+            }
+            else if (arg.isLongOption("params"))
+            {
+                juce::String error;
+                if (!parseParameterFile(juce::File::getCurrentWorkingDirectory().getChildFile(takeValue()),
+                                        settings.parameterValues, error))
+                    throw std::runtime_error(error.toStdString());
+            }
+            else if (arg.isOption())
+                throw std::runtime_error(("unknown option " + arg.text).toStdString());
+            else
+            {
+                const auto file = arg.resolveAsFile();
+                if (!file.existsAsFile())
+                    throw std::runtime_error(("no such file " + file.getFullPathName()).toStdString());
+                inputs.add(file);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "kina_render: " << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    if (inputs.isEmpty() || settings.blockSize <= 0
+        || (settings.bitsPerSample != 16 && settings.bitsPerSample != 24 && settings.bitsPerSample != 32))
+    {
+        printUsage();
+        return 1;
+    }
+
+    // One processor per worker. They're created here because the parameter
+    // machinery expects to be set up on the message thread.
+    numJobs = juce::jlimit(1, inputs.size(), numJobs);
+    std::vector<std::unique_ptr<KinaVSTProcessor>> processors;
+
+    for (int i = 0; i < numJobs; ++i)
+    {
+        auto processor = std::make_unique<KinaVSTProcessor>();
+        juce::String error;
+        if (!configureProcessor(*processor, settings, error))
+        {
+            std::cerr << "kina_render: " << error << "\n";
+            return 1;
+        }
+        processors.push_back(std::move(processor));
+    }
+
+    const bool isBatch = inputs.size() > 1;
+    std::atomic<int> nextInput { 0 };
+    std::atomic<int> numFailed { 0 };
+    std::mutex outputMutex;
+
+    const auto worker = [&](KinaVSTProcessor& processor)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        for (int index = nextInput++; index < inputs.size(); index = nextInput++)
+        {
+            const auto& input = inputs.getReference(index);
+            const auto output = getOutputFile(input, outputOption, isBatch);
+            const auto result = renderFile(processor, formats, input, output, settings);
+
+            const std::lock_guard<std::mutex> lock(outputMutex);
+            if (result.ok)
+            {
+                std::cout << input.getFileName() << " -> " << output.getFullPathName() << ": "
+                          << juce::String(result.audioSeconds, 2) << " s audio in "
+                          << juce::String(result.wallSeconds, 3) << " s ("
+                          << juce::String(result.audioSeconds / juce::jmax(result.wallSeconds, 1.0e-9), 1)
+                          << "x realtime)\n";
+            }
+            else
+            {
+                std::cerr << input.getFileName() << ": " << result.message << "\n";
+                ++numFailed;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (auto& processor : processors)
+        threads.emplace_back(worker, std::ref(*processor));
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return numFailed > 0 ? 1 : 0;
+}